@@ -0,0 +1,124 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../include/utils.h"
+
+#define INITIAL_SIZE 2000
+#define OPERATIONS 20000
+
+// Contention benchmark: every thread runs the same mix of reads and writes
+// at random positions on one shared list.
+
+typedef struct Workload
+{
+    void *list;
+    int write_percent;
+    unsigned int seed;
+} Workload;
+
+static pthread_mutex_t global_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void *run_global_mutex(void *arg)
+{
+    Workload *work = arg;
+    for (int i = 0; i < OPERATIONS; i++)
+    {
+        int choice = rand_r(&work->seed) % 100;
+        size_t position = rand_r(&work->seed) % INITIAL_SIZE;
+        pthread_mutex_lock(&global_lock);
+        if (choice < work->write_percent / 2)
+            insert_at(work->list, NULL, position);
+        else if (choice < work->write_percent)
+            remove_at(work->list, position);
+        else
+            get_at(work->list, position);
+        pthread_mutex_unlock(&global_lock);
+    }
+    return NULL;
+}
+
+static void *run_concurrent(void *arg)
+{
+    Workload *work = arg;
+    for (int i = 0; i < OPERATIONS; i++)
+    {
+        int choice = rand_r(&work->seed) % 100;
+        size_t position = rand_r(&work->seed) % INITIAL_SIZE;
+        if (choice < work->write_percent / 2)
+            clist_insert_at(work->list, NULL, position);
+        else if (choice < work->write_percent)
+            clist_remove_at(work->list, position);
+        else
+            clist_get_at(work->list, position);
+    }
+    return NULL;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double run(void *(*worker)(void *), void *list, int threads,
+                  int write_percent)
+{
+    pthread_t ids[threads];
+    Workload work[threads];
+    double start = now();
+    for (int t = 0; t < threads; t++)
+    {
+        work[t].list = list;
+        work[t].write_percent = write_percent;
+        work[t].seed = 42 + t;
+        pthread_create(&ids[t], NULL, worker, &work[t]);
+    }
+    for (int t = 0; t < threads; t++)
+        pthread_join(ids[t], NULL);
+    return threads * (double)OPERATIONS / (now() - start);
+}
+
+int main()
+{
+    int thread_counts[] = {1, 2, 4, 8};
+    int write_percents[] = {5, 50};
+
+    printf("%-8s %6s %16s %16s %16s\n", "threads", "writes", "global mutex",
+           "rwlock", "lock coupling");
+    for (int w = 0; w < 2; w++)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            int threads = thread_counts[c];
+            LinkedList *list = init_linked_list(NULL);
+            ConcurrentList *rwlock =
+                init_concurrent_list(CONCURRENT_LIST_RWLOCK, NULL);
+            ConcurrentList *coupling =
+                init_concurrent_list(CONCURRENT_LIST_LOCK_COUPLING, NULL);
+            for (int i = 0; i < INITIAL_SIZE; i++)
+            {
+                insert_at(list, NULL, 0);
+                clist_insert_at(rwlock, NULL, 0);
+                clist_insert_at(coupling, NULL, 0);
+            }
+
+            double global_rate =
+                run(run_global_mutex, list, threads, write_percents[w]);
+            double rwlock_rate =
+                run(run_concurrent, rwlock, threads, write_percents[w]);
+            double coupling_rate =
+                run(run_concurrent, coupling, threads, write_percents[w]);
+            printf("%-8d %5d%% %11.0f op/s %11.0f op/s %11.0f op/s\n",
+                   threads, write_percents[w], global_rate, rwlock_rate,
+                   coupling_rate);
+
+            free_linked_list(list);
+            free_concurrent_list(rwlock);
+            free_concurrent_list(coupling);
+        }
+    }
+    return 0;
+}
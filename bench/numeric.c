@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../include/utils.h"
+
+#define COUNT 1000000
+#define ROUNDS 20
+
+// Aggregation over the same values: a LinkedList of int payloads walked with
+// foreach, then a NumericArray with each available instruction set.
+
+static long long list_sum;
+
+static void add_to_sum(void *data)
+{
+    list_sum += *(int *)data;
+}
+
+static int greater_than_10(void *data)
+{
+    return *(int *)data > 10;
+}
+
+static size_t list_count;
+
+static void count_greater_than_10(void *data)
+{
+    list_count += greater_than_10(data);
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main()
+{
+    int *values = malloc(COUNT * sizeof(int));
+    void **items = malloc(COUNT * sizeof(void *));
+    for (int i = 0; i < COUNT; i++)
+    {
+        values[i] = rand() % 100;
+        items[i] = &values[i];
+    }
+    LinkedList *list = list_from_array(items, COUNT, NULL);
+    NumericArray *array = numeric_from_list(list, NUMERIC_INT);
+
+    double start = now();
+    for (int r = 0; r < ROUNDS; r++)
+    {
+        foreach(list, add_to_sum);
+        foreach(list, count_greater_than_10);
+    }
+    double elapsed = now() - start;
+    printf("%-12s %8.2f ms per round (sum %lld, count %zu)\n", "list",
+           elapsed * 1000 / ROUNDS, list_sum / ROUNDS, list_count / ROUNDS);
+
+    const char *names[] = {"scalar", "sse2", "avx2"};
+    NumericIsa isas[] = {NUMERIC_SCALAR, NUMERIC_SSE2, NUMERIC_AVX2};
+    for (int i = 0; i < 3; i++)
+    {
+        if (numeric_set_isa(isas[i]) != isas[i])
+            continue;
+        double sum = 0;
+        size_t count = 0;
+        start = now();
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            sum += num_sum(array);
+            count += num_count_if(array, NUMERIC_GT, 10.0);
+        }
+        elapsed = now() - start;
+        printf("%-12s %8.2f ms per round (sum %.0f, count %zu)\n", names[i],
+               elapsed * 1000 / ROUNDS, sum / ROUNDS, count / ROUNDS);
+    }
+
+    free_numeric_array(array);
+    free_linked_list(list);
+    free(items);
+    free(values);
+    return 0;
+}
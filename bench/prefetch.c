@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../src/linked_list.h"
+
+#define COUNT 2000000
+#define ROUNDS 5
+
+// Traversal benchmark on a list whose nodes and payloads are scattered
+// across the heap: they are allocated in order, then linked in a random
+// order, as after a long run of insertions and removals.
+
+static long long sum;
+
+static void add_to_sum(void *data)
+{
+    sum += *(int *)data;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void shuffle(void **items, size_t count)
+{
+    for (size_t i = count - 1; i > 0; i--)
+    {
+        size_t j = (size_t)rand() % (i + 1);
+        void *tmp = items[i];
+        items[i] = items[j];
+        items[j] = tmp;
+    }
+}
+
+static LinkedList *make_shuffled_list(void)
+{
+    void **payloads = malloc(COUNT * sizeof(void *));
+    Node **nodes = malloc(COUNT * sizeof(Node *));
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        int *num = malloc(sizeof(int));
+        *num = (int)i;
+        payloads[i] = num;
+    }
+    for (size_t i = 0; i < COUNT; i++)
+        nodes[i] = create_node(NULL, NULL);
+
+    // Payloads and links follow two independent random orders
+    shuffle(payloads, COUNT);
+    shuffle((void **)nodes, COUNT);
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        nodes[i]->data = payloads[i];
+        nodes[i]->next = i + 1 < COUNT ? nodes[i + 1] : NULL;
+    }
+
+    LinkedList *list = init_linked_list(free);
+    list->head = nodes[0];
+    list->size = COUNT;
+    free(nodes);
+    free(payloads);
+    return list;
+}
+
+int main()
+{
+    size_t distances[] = {0, 2, 4, 8, 16};
+
+    printf("%-9s %-9s %14s %14s\n", "distance", "payloads", "foreach",
+           "free");
+    for (int payloads = 0; payloads < 2; payloads++)
+    {
+        for (int d = 0; d < 5; d++)
+        {
+            set_prefetch_distance(distances[d]);
+            set_prefetch_payloads(payloads);
+
+            double traversal = 0;
+            double release = 0;
+            for (int r = 0; r < ROUNDS; r++)
+            {
+                srand(r + 1);
+                LinkedList *list = make_shuffled_list();
+
+                double start = now();
+                foreach(list, add_to_sum);
+                traversal += now() - start;
+
+                start = now();
+                free_linked_list(list);
+                release += now() - start;
+            }
+            printf("%-9zu %-9s %11.1f ms %11.1f ms\n", distances[d],
+                   payloads ? "yes" : "no", traversal * 1000 / ROUNDS,
+                   release * 1000 / ROUNDS);
+        }
+    }
+    return sum == 0;
+}
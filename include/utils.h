@@ -2,9 +2,81 @@
 #define UTILS_H
 
 #include <stddef.h>
+#include <sys/types.h>
 
 typedef struct LinkedList LinkedList;
 typedef struct Stack Stack;
+typedef struct ConcurrentList ConcurrentList;
+typedef struct ListSnapshot ListSnapshot;
+typedef struct NumericArray NumericArray;
+typedef struct PriorityQueue PriorityQueue;
+typedef size_t PQHandle;
+
+// Link embedded in a user struct to chain it into an IntrusiveList or an
+// IntrusiveStack; container_of gets the struct back from the link
+typedef struct ListLink
+{
+    struct ListLink *next;
+} ListLink;
+
+typedef struct IntrusiveList
+{
+    ListLink *head;
+    ListLink *tail;
+    size_t size;
+} IntrusiveList;
+
+typedef struct IntrusiveStack
+{
+    ListLink *head;
+    size_t size;
+} IntrusiveStack;
+
+#define container_of(ptr, type, member)                                        \
+    ((type *)((char *)(ptr) - offsetof(type, member)))
+
+typedef enum ConcurrentListMode
+{
+    CONCURRENT_LIST_RWLOCK,
+    CONCURRENT_LIST_LOCK_COUPLING
+} ConcurrentListMode;
+
+typedef enum NumericType
+{
+    NUMERIC_INT,
+    NUMERIC_DOUBLE
+} NumericType;
+
+typedef enum NumericOp
+{
+    NUMERIC_LT,
+    NUMERIC_LE,
+    NUMERIC_GT,
+    NUMERIC_GE,
+    NUMERIC_EQ,
+    NUMERIC_NE
+} NumericOp;
+
+typedef enum NumericIsa
+{
+    NUMERIC_SCALAR,
+    NUMERIC_SSE2,
+    NUMERIC_AVX2
+} NumericIsa;
+
+// Estimated heap footprint of a container. Node bytes are the nodes
+// themselves, overhead bytes the allocator headers and padding, unused block
+// slots and container bookkeeping, and payload bytes what the caller's
+// payload_size callback reports. The overhead ratio is the share of the total
+// not spent on payloads.
+typedef struct MemoryUsage
+{
+    size_t elements;
+    size_t node_bytes;
+    size_t overhead_bytes;
+    size_t payload_bytes;
+    double overhead_ratio;
+} MemoryUsage;
 
 // linked list
 LinkedList *init_linked_list(void (*free_data)(void *));
@@ -16,8 +88,91 @@ void foreach(LinkedList *list, void (*func)(void *));
 LinkedList *map(LinkedList *list, void *(*func)(void *),
                 void (*free_data)(void *));
 LinkedList *filter(LinkedList *list, int (*predicate)(void *));
+LinkedList *partition(LinkedList *list, int (*predicate)(void *));
+LinkedList **group_by(LinkedList *list, size_t (*bucket)(void *data),
+                      size_t nbuckets);
+LinkedList **group_by_parallel(LinkedList *list,
+                               size_t (*bucket)(void *data), size_t nbuckets,
+                               size_t nthreads);
+void *reduce(LinkedList *list, void *init,
+             void *(*combine)(void *acc, void *data));
+void *parallel_reduce(LinkedList *list, void *(*identity)(void),
+                      void *(*combine)(void *acc, void *data),
+                      void *(*merge)(void *acc, void *other),
+                      void (*destroy)(void *acc), size_t nthreads);
 void sort(LinkedList *list, int (*cmp)(const void *, const void *));
+LinkedList *top_k(LinkedList *list, size_t k,
+                  int (*cmp)(const void *, const void *));
+void partial_sort(LinkedList *list, size_t k,
+                  int (*cmp)(const void *, const void *));
+void insert_sorted(LinkedList *list, void *data,
+                   int (*cmp)(const void *, const void *));
+void merge_sorted(LinkedList *list, LinkedList *other,
+                  int (*cmp)(const void *, const void *));
+LinkedList *kway_merge(LinkedList **lists, size_t k,
+                       int (*cmp)(const void *, const void *));
+void *find_sorted(LinkedList *list, const void *key,
+                  int (*cmp)(const void *, const void *));
+size_t list_length(LinkedList *list);
+size_t list_to_array(LinkedList *list, void **out);
+LinkedList *list_from_array(void **items, size_t count,
+                            void (*free_data)(void *));
+LinkedList *list_clone_cow(LinkedList *list);
+int list_compact(LinkedList *list);
+double list_fragmentation(LinkedList *list);
+void list_set_auto_compact(LinkedList *list, double churn_ratio);
+MemoryUsage list_memory_usage(LinkedList *list,
+                              size_t (*payload_size)(const void *data));
+int list_track_memory(LinkedList *list, const char *name,
+                      size_t (*payload_size)(const void *data));
+int list_attach_index(LinkedList *list, size_t (*hash)(const void *data),
+                      int (*eq)(const void *a, const void *b));
+void list_detach_index(LinkedList *list);
+void *list_find(LinkedList *list, const void *key);
+int list_contains(LinkedList *list, const void *key);
+int list_remove_key(LinkedList *list, const void *key);
 void free_linked_list(LinkedList *list);
+void free_linked_list_async(LinkedList *list);
+
+// external sort
+int external_sort(LinkedList *list, int (*cmp)(const void *, const void *),
+                  size_t (*serialize)(const void *data, void *buffer,
+                                      size_t capacity),
+                  void *(*deserialize)(const void *buffer, size_t size),
+                  size_t mem_budget, const char *tmpdir);
+int external_sort_stream(LinkedList *list,
+                         int (*cmp)(const void *, const void *),
+                         size_t (*serialize)(const void *data, void *buffer,
+                                             size_t capacity),
+                         void *(*deserialize)(const void *buffer, size_t size),
+                         size_t mem_budget, const char *tmpdir,
+                         void (*consumer)(void *data, void *context),
+                         void *context);
+
+// bulk ingestion
+ssize_t list_ingest_fd(LinkedList *list, int fd,
+                       void *(*parse)(const char *line, size_t length,
+                                      void *context),
+                       void *context);
+ssize_t list_ingest_mmap(LinkedList *list, const char *path,
+                         void *(*parse)(const char *line, size_t length,
+                                        void *context),
+                         void *context);
+
+// prefetching
+void set_prefetch_distance(size_t distance);
+void set_prefetch_payloads(int enabled);
+
+// linked list snapshots
+int list_save(LinkedList *list, const char *path,
+              size_t (*serialize)(const void *data, void *buffer,
+                                  size_t capacity));
+int list_save_inline(LinkedList *list, const char *path, size_t element_size);
+LinkedList *list_load_mmap(const char *path, ListSnapshot **snapshot);
+size_t snapshot_length(ListSnapshot *snapshot);
+const void *snapshot_get(ListSnapshot *snapshot, size_t position,
+                         size_t *size);
+void free_snapshot(ListSnapshot *snapshot);
 
 // stack
 Stack *init_stack(void (*free_data)(void *data));
@@ -25,6 +180,85 @@ void push(Stack *stack, void *data);
 void *pop(Stack *stack);
 int is_empty(Stack *stack);
 size_t length(Stack *stack);
+Stack *stack_from_array(void **items, size_t count,
+                        void (*free_data)(void *data));
+size_t stack_to_array(Stack *stack, void **out);
+MemoryUsage stack_memory_usage(Stack *stack,
+                               size_t (*payload_size)(const void *data));
+int stack_track_memory(Stack *stack, const char *name,
+                       size_t (*payload_size)(const void *data));
 void free_stack(Stack *stack);
+void free_stack_async(Stack *stack);
+
+// background reclamation
+void utils_reclaimer_drain(void);
+
+// memory usage registry
+MemoryUsage memory_registry_total(void);
+void memory_registry_export(void (*emit)(const char *name,
+                                         const MemoryUsage *usage,
+                                         void *context),
+                            void *context);
+
+// priority queue
+PriorityQueue *init_pqueue(int (*cmp)(const void *, const void *),
+                           void (*free_data)(void *));
+void pq_push(PriorityQueue *pq, void *data);
+int pq_push_handle(PriorityQueue *pq, void *data, PQHandle *handle);
+int pq_push_n(PriorityQueue *pq, void **items, size_t count);
+void *pq_peek(PriorityQueue *pq);
+void *pq_pop(PriorityQueue *pq);
+void pq_decrease_key(PriorityQueue *pq, PQHandle handle);
+size_t pq_length(PriorityQueue *pq);
+void free_pqueue(PriorityQueue *pq);
+
+// intrusive list and stack
+void init_intrusive_list(IntrusiveList *list);
+void list_link_append(IntrusiveList *list, ListLink *link);
+void list_link_insert_at(IntrusiveList *list, ListLink *link,
+                         size_t position);
+ListLink *list_link_remove_at(IntrusiveList *list, size_t position);
+ListLink *list_link_get_at(IntrusiveList *list, size_t position);
+void list_link_foreach(IntrusiveList *list, void (*func)(ListLink *link));
+void list_link_sort(IntrusiveList *list,
+                    int (*cmp)(const void *a, const void *b));
+size_t list_link_length(IntrusiveList *list);
+void free_intrusive_list(IntrusiveList *list,
+                         void (*free_item)(ListLink *link));
+void init_intrusive_stack(IntrusiveStack *stack);
+void stack_link_push(IntrusiveStack *stack, ListLink *link);
+ListLink *stack_link_pop(IntrusiveStack *stack);
+ListLink *stack_link_peek(IntrusiveStack *stack);
+void stack_link_foreach(IntrusiveStack *stack, void (*func)(ListLink *link));
+size_t stack_link_length(IntrusiveStack *stack);
+void free_intrusive_stack(IntrusiveStack *stack,
+                          void (*free_item)(ListLink *link));
+
+// concurrent linked list
+ConcurrentList *init_concurrent_list(ConcurrentListMode mode,
+                                     void (*free_data)(void *));
+void clist_append(ConcurrentList *list, void *data);
+void clist_insert_at(ConcurrentList *list, void *data, size_t position);
+void clist_remove_at(ConcurrentList *list, size_t position);
+void *clist_get_at(ConcurrentList *list, size_t position);
+void clist_foreach(ConcurrentList *list, void (*func)(void *));
+size_t clist_length(ConcurrentList *list);
+void free_concurrent_list(ConcurrentList *list);
+
+// numeric array
+NumericArray *init_numeric_array(size_t capacity);
+NumericArray *numeric_from_list(LinkedList *list, NumericType type);
+void num_push(NumericArray *array, double value);
+size_t num_length(NumericArray *array);
+double *num_data(NumericArray *array);
+double num_sum(NumericArray *array);
+double num_min(NumericArray *array);
+double num_max(NumericArray *array);
+size_t num_count_if(NumericArray *array, NumericOp op, double threshold);
+NumericArray *num_filter(NumericArray *array, NumericOp op, double threshold);
+void num_map_affine(NumericArray *array, double scale, double offset);
+void free_numeric_array(NumericArray *array);
+NumericIsa numeric_isa(void);
+NumericIsa numeric_set_isa(NumericIsa isa);
 
 #endif /* UTILS_H */
\ No newline at end of file
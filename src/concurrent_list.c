@@ -0,0 +1,269 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "../include/utils.h"
+
+typedef struct ConcurrentNode
+{
+    void *data;
+    struct ConcurrentNode *next;
+    pthread_mutex_t lock; // guards `next`, used in lock coupling mode
+} ConcurrentNode;
+
+struct ConcurrentList
+{
+    ConcurrentNode head; // sentinel, its lock guards the first link
+    atomic_size_t size;
+    ConcurrentListMode mode;
+    pthread_rwlock_t rwlock; // guards the whole list in rwlock mode
+    void (*free_data)(void *data);
+};
+
+/**
+ * @brief Initialize a new thread-safe linked list.
+ *
+ * Two locking schemes are available. CONCURRENT_LIST_RWLOCK protects the
+ * whole list with a reader-writer lock, so any number of get_at and foreach
+ * calls run in parallel while mutations are exclusive. It suits mostly-read
+ * workloads. CONCURRENT_LIST_LOCK_COUPLING gives each node its own mutex and
+ * walks the list hand over hand, holding at most two node locks at a time, so
+ * insertions and removals at different positions proceed in parallel.
+ *
+ * @param[in] mode Locking scheme of the list.
+ * @param[in] free_data Function pointer used to free the data stored in the
+ * list nodes, or NULL.
+ * @return Pointer to the newly created ConcurrentList, or NULL if memory
+ * allocation fails.
+ */
+ConcurrentList *init_concurrent_list(ConcurrentListMode mode,
+                                     void (*free_data)(void *))
+{
+    ConcurrentList *list = malloc(sizeof(ConcurrentList));
+    if (!list)
+        return NULL;
+    if (pthread_rwlock_init(&list->rwlock, NULL) != 0)
+    {
+        free(list);
+        return NULL;
+    }
+    pthread_mutex_init(&list->head.lock, NULL);
+    list->head.data = NULL;
+    list->head.next = NULL;
+    atomic_init(&list->size, 0);
+    list->mode = mode;
+    list->free_data = free_data;
+    return list;
+}
+
+// Return the node after which `position` lies, locked in lock coupling mode.
+// The walk stops early on the last node when the list is shorter.
+static ConcurrentNode *lock_predecessor(ConcurrentList *list, size_t position)
+{
+    ConcurrentNode *previous = &list->head;
+    int coupling = list->mode == CONCURRENT_LIST_LOCK_COUPLING;
+
+    if (coupling)
+        pthread_mutex_lock(&previous->lock);
+    for (size_t index = 0; index < position && previous->next; index++)
+    {
+        ConcurrentNode *current = previous->next;
+        if (coupling)
+        {
+            pthread_mutex_lock(&current->lock);
+            pthread_mutex_unlock(&previous->lock);
+        }
+        previous = current;
+    }
+    return previous;
+}
+
+static void unlock_node(ConcurrentList *list, ConcurrentNode *node)
+{
+    if (list->mode == CONCURRENT_LIST_LOCK_COUPLING)
+        pthread_mutex_unlock(&node->lock);
+}
+
+static void lock_list(ConcurrentList *list, int write)
+{
+    if (list->mode != CONCURRENT_LIST_RWLOCK)
+        return;
+    if (write)
+        pthread_rwlock_wrlock(&list->rwlock);
+    else
+        pthread_rwlock_rdlock(&list->rwlock);
+}
+
+static void unlock_list(ConcurrentList *list)
+{
+    if (list->mode == CONCURRENT_LIST_RWLOCK)
+        pthread_rwlock_unlock(&list->rwlock);
+}
+
+/**
+ * @brief Insert an element at a specified position in the list.
+ *
+ * If position is greater than the size of the list, the element is appended
+ * at the end, like insert_at does.
+ *
+ * @param[in] list Pointer to the concurrent list.
+ * @param[in] data Pointer to the data to store in the new node.
+ * @param[in] position The position at which to insert the new node (0-based
+ * index).
+ */
+void clist_insert_at(ConcurrentList *list, void *data, size_t position)
+{
+    ConcurrentNode *new_node = malloc(sizeof(ConcurrentNode));
+    if (!new_node)
+        return;
+    new_node->data = data;
+    pthread_mutex_init(&new_node->lock, NULL);
+
+    lock_list(list, 1);
+    ConcurrentNode *previous = lock_predecessor(list, position);
+    new_node->next = previous->next;
+    previous->next = new_node;
+    atomic_fetch_add(&list->size, 1);
+    unlock_node(list, previous);
+    unlock_list(list);
+}
+
+/**
+ * @brief Append an element at the end of the list.
+ *
+ * @param[in] list Pointer to the concurrent list.
+ * @param[in] data Pointer to the data to store in the new node.
+ */
+void clist_append(ConcurrentList *list, void *data)
+{
+    clist_insert_at(list, data, SIZE_MAX);
+}
+
+/**
+ * @brief Remove the element at a specified position in the list.
+ *
+ * The data is freed with the free_data function of the list. If the position
+ * is out of bounds, the function does nothing.
+ *
+ * @param[in] list Pointer to the concurrent list.
+ * @param[in] position The position of the node to remove (0-based index).
+ */
+void clist_remove_at(ConcurrentList *list, size_t position)
+{
+    lock_list(list, 1);
+    ConcurrentNode *previous = lock_predecessor(list, position);
+    ConcurrentNode *victim = previous->next;
+    if (!victim)
+    {
+        unlock_node(list, previous);
+        unlock_list(list);
+        return;
+    }
+
+    // Wait for any walker still standing on the victim to move past it
+    if (list->mode == CONCURRENT_LIST_LOCK_COUPLING)
+        pthread_mutex_lock(&victim->lock);
+    previous->next = victim->next;
+    atomic_fetch_sub(&list->size, 1);
+    unlock_node(list, victim);
+    unlock_node(list, previous);
+    unlock_list(list);
+
+    if (list->free_data)
+        list->free_data(victim->data);
+    pthread_mutex_destroy(&victim->lock);
+    free(victim);
+}
+
+/**
+ * @brief Get the data at a specified position in the list.
+ *
+ * The returned data stays valid only while no other thread removes the
+ * element.
+ *
+ * @param[in] list Pointer to the concurrent list.
+ * @param[in] position The position of the node to retrieve (0-based index).
+ * @return Pointer to the data stored at the specified position, or NULL if
+ * out of bounds.
+ */
+void *clist_get_at(ConcurrentList *list, size_t position)
+{
+    lock_list(list, 0);
+    ConcurrentNode *previous = lock_predecessor(list, position);
+    void *data = previous->next ? previous->next->data : NULL;
+    unlock_node(list, previous);
+    unlock_list(list);
+    return data;
+}
+
+/**
+ * @brief Apply a function to each element in the list.
+ *
+ * In lock coupling mode the function runs while the lock of the current node
+ * is held, so writers behind the walker wait while writers ahead of it
+ * proceed. `func` must not call back into the same list.
+ *
+ * @param[in] list Pointer to the concurrent list.
+ * @param[in] func Function to apply to each element's data.
+ */
+void clist_foreach(ConcurrentList *list, void (*func)(void *))
+{
+    int coupling = list->mode == CONCURRENT_LIST_LOCK_COUPLING;
+
+    lock_list(list, 0);
+    ConcurrentNode *previous = &list->head;
+    if (coupling)
+        pthread_mutex_lock(&previous->lock);
+    while (previous->next)
+    {
+        ConcurrentNode *current = previous->next;
+        if (coupling)
+        {
+            pthread_mutex_lock(&current->lock);
+            pthread_mutex_unlock(&previous->lock);
+        }
+        func(current->data);
+        previous = current;
+    }
+    unlock_node(list, previous);
+    unlock_list(list);
+}
+
+/**
+ * @brief Get the number of elements in the list.
+ *
+ * @param[in] list Pointer to the concurrent list.
+ * @return The number of elements in the list at the time of the call.
+ */
+size_t clist_length(ConcurrentList *list)
+{
+    return list ? atomic_load(&list->size) : 0;
+}
+
+/**
+ * @brief Free the list and its data.
+ *
+ * No other thread may use the list during or after this call.
+ *
+ * @param[in] list Pointer to the concurrent list to free.
+ */
+void free_concurrent_list(ConcurrentList *list)
+{
+    if (!list)
+        return;
+
+    ConcurrentNode *current = list->head.next;
+    while (current)
+    {
+        ConcurrentNode *next_node = current->next;
+        if (list->free_data)
+            list->free_data(current->data);
+        pthread_mutex_destroy(&current->lock);
+        free(current);
+        current = next_node;
+    }
+    pthread_mutex_destroy(&list->head.lock);
+    pthread_rwlock_destroy(&list->rwlock);
+    free(list);
+}
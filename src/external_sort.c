@@ -0,0 +1,606 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "linked_list.h"
+#include "retire.h"
+
+// Largest number of runs merged at once; more runs are merged in passes.
+// Runs are only open while they are written or merged, so this also bounds
+// the number of descriptors in use.
+#define MAX_FAN_IN 64
+#define RUN_BUFFER_SIZE (1 << 16)
+
+typedef struct Buffer
+{
+    unsigned char *bytes;
+    size_t capacity;
+} Buffer;
+
+// A sorted run on disk. Runs hold contiguous ranges of the original chunks
+// and rank is the first of them, which orders equal records between runs.
+// The file is closed between uses and reopened by path.
+typedef struct Run
+{
+    char *path;
+    size_t rank;
+} Run;
+
+typedef struct RunSet
+{
+    Run *runs;
+    size_t count;
+    size_t capacity;
+} RunSet;
+
+typedef struct Codec
+{
+    int (*cmp)(const void *, const void *);
+    size_t (*serialize)(const void *, void *, size_t);
+    void *(*deserialize)(const void *, size_t);
+    void (*free_data)(void *);
+    const char *tmpdir;
+} Codec;
+
+typedef struct RunReader
+{
+    FILE *file;
+    void *data;
+    size_t rank;
+} RunReader;
+
+static int reserve(Buffer *buffer, size_t size)
+{
+    if (size <= buffer->capacity)
+        return 0;
+    unsigned char *bytes = realloc(buffer->bytes, size);
+    if (!bytes)
+        return -1;
+    buffer->bytes = bytes;
+    buffer->capacity = size;
+    return 0;
+}
+
+// Create a temporary file in tmpdir and add it to the runs, open for writing
+static FILE *open_run(RunSet *runs, const char *tmpdir, size_t rank)
+{
+    if (runs->count == runs->capacity)
+    {
+        size_t capacity = runs->capacity ? 2 * runs->capacity : 16;
+        Run *grown = realloc(runs->runs, capacity * sizeof(Run));
+        if (!grown)
+            return NULL;
+        runs->runs = grown;
+        runs->capacity = capacity;
+    }
+
+    const char *dir = tmpdir ? tmpdir : "/tmp";
+    size_t length = strlen(dir) + sizeof("/libutils_run_XXXXXX");
+    char *path = malloc(length);
+    if (!path)
+        return NULL;
+    snprintf(path, length, "%s/libutils_run_XXXXXX", dir);
+
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        free(path);
+        return NULL;
+    }
+
+    FILE *file = fdopen(fd, "w");
+    if (!file)
+    {
+        close(fd);
+        unlink(path);
+        free(path);
+        return NULL;
+    }
+    setvbuf(file, NULL, _IOFBF, RUN_BUFFER_SIZE);
+    runs->runs[runs->count].path = path;
+    runs->runs[runs->count].rank = rank;
+    runs->count++;
+    return file;
+}
+
+// Close a run that was being written, and remove it if writing failed.
+// Returns the status of the run.
+static int close_run(RunSet *runs, FILE *file, int status)
+{
+    if (fclose(file) != 0)
+        status = -1;
+    if (status != 0)
+    {
+        runs->count--;
+        unlink(runs->runs[runs->count].path);
+        free(runs->runs[runs->count].path);
+    }
+    return status;
+}
+
+// Delete the files of runs [first, last)
+static void remove_runs(Run *runs, size_t first, size_t last)
+{
+    for (size_t i = first; i < last; i++)
+    {
+        unlink(runs[i].path);
+        free(runs[i].path);
+    }
+}
+
+static FILE *reopen_run(const Run *run)
+{
+    FILE *file = fopen(run->path, "r");
+    if (file)
+        setvbuf(file, NULL, _IOFBF, RUN_BUFFER_SIZE);
+    return file;
+}
+
+// Records are stored as a 64-bit size followed by the serialized bytes
+static int write_record(FILE *file, const void *data, const Codec *codec,
+                        Buffer *scratch)
+{
+    size_t size = codec->serialize(data, scratch->bytes, scratch->capacity);
+    if (size > scratch->capacity)
+    {
+        if (reserve(scratch, size) < 0)
+            return -1;
+        codec->serialize(data, scratch->bytes, scratch->capacity);
+    }
+
+    uint64_t header = size;
+    if (fwrite(&header, sizeof(header), 1, file) != 1
+        || fwrite(scratch->bytes, 1, size, file) != size)
+        return -1;
+    return 0;
+}
+
+// Read the next record of a run: 1 when one was read, 0 at the end, -1 on
+// error
+static int read_record(FILE *file, const Codec *codec, Buffer *scratch,
+                       void **data)
+{
+    uint64_t size;
+    if (fread(&size, sizeof(size), 1, file) != 1)
+        return feof(file) ? 0 : -1;
+    if (size > SIZE_MAX || reserve(scratch, (size_t)size) < 0
+        || fread(scratch->bytes, 1, (size_t)size, file) != size)
+        return -1;
+
+    *data = codec->deserialize(scratch->bytes, (size_t)size);
+    return 1;
+}
+
+// Min-heap order on the current record of each run, ties by run rank so
+// that the merge stays stable
+static int reader_before(const RunReader *a, const RunReader *b,
+                         const Codec *codec)
+{
+    int order = codec->cmp(a->data, b->data);
+    return order < 0 || (order == 0 && a->rank < b->rank);
+}
+
+static void reader_sift_down(RunReader *heap, size_t size, size_t index,
+                             const Codec *codec)
+{
+    for (;;)
+    {
+        size_t smallest = index;
+        size_t left = 2 * index + 1;
+        size_t right = left + 1;
+
+        if (left < size && reader_before(&heap[left], &heap[smallest], codec))
+            smallest = left;
+        if (right < size
+            && reader_before(&heap[right], &heap[smallest], codec))
+            smallest = right;
+        if (smallest == index)
+            break;
+
+        RunReader tmp = heap[smallest];
+        heap[smallest] = heap[index];
+        heap[index] = tmp;
+        index = smallest;
+    }
+}
+
+// K-way merge of `count` runs, handing each payload in order to `emit`,
+// which takes ownership of it
+static int merge_runs(Run *runs, size_t count, const Codec *codec,
+                      Buffer *scratch, int (*emit)(void *, void *),
+                      void *context)
+{
+    RunReader *heap = malloc(count * sizeof(RunReader));
+    if (!heap)
+        return -1;
+
+    // The runs are open for the duration of the merge only
+    FILE **files = malloc(count * sizeof(FILE *));
+    if (!files)
+    {
+        free(heap);
+        return -1;
+    }
+
+    int status = 0;
+    size_t size = 0;
+    size_t opened = 0;
+    for (size_t i = 0; i < count && status == 0; i++)
+    {
+        FILE *file = reopen_run(&runs[i]);
+        if (!file)
+        {
+            status = -1;
+            break;
+        }
+        files[opened++] = file;
+        heap[size].file = file;
+        heap[size].rank = runs[i].rank;
+        int read = read_record(file, codec, scratch, &heap[size].data);
+        if (read < 0)
+            status = -1;
+        else if (read > 0)
+            size++;
+    }
+    for (size_t i = size / 2; i-- > 0;)
+        reader_sift_down(heap, size, i, codec);
+
+    while (size && status == 0)
+    {
+        void *data = heap[0].data;
+        heap[0].data = NULL;
+        if (emit(data, context) < 0)
+            break;
+
+        int read = read_record(heap[0].file, codec, scratch, &heap[0].data);
+        if (read < 0)
+            break;
+        if (read == 0)
+            heap[0] = heap[--size];
+        reader_sift_down(heap, size, 0, codec);
+    }
+
+    // On error, release the payloads already read from the runs
+    if (size)
+        status = -1;
+    for (size_t i = 0; i < size && codec->free_data; i++)
+    {
+        if (heap[i].data)
+            codec->free_data(heap[i].data);
+    }
+    for (size_t i = 0; i < opened; i++)
+        fclose(files[i]);
+    free(files);
+    free(heap);
+    return status;
+}
+
+typedef struct RunWriter
+{
+    FILE *file;
+    const Codec *codec;
+    Buffer *scratch;
+} RunWriter;
+
+static int emit_to_run(void *data, void *context)
+{
+    RunWriter *writer = context;
+    int status =
+        write_record(writer->file, data, writer->codec, writer->scratch);
+    if (writer->codec->free_data)
+        writer->codec->free_data(data);
+    return status;
+}
+
+typedef struct Consumer
+{
+    void (*consume)(void *data, void *context);
+    void *context;
+} Consumer;
+
+static int emit_to_consumer(void *data, void *context)
+{
+    Consumer *consumer = context;
+    consumer->consume(data, consumer->context);
+    return 0;
+}
+
+// Sort the chain in memory with the list sort, in a list of its own
+static Node *sort_chain(Node *head, size_t count, const Codec *codec)
+{
+    LinkedList chunk = {.head = head, .size = count};
+    sort(&chunk, codec->cmp);
+    return chunk.head;
+}
+
+// Write a sorted chain of `list` to a new run and free it. If the run cannot
+// be written, the chain is left untouched.
+static int spill_chain(LinkedList *list, RunSet *runs, Node *head,
+                       const Codec *codec, Buffer *scratch)
+{
+    FILE *file = open_run(runs, codec->tmpdir, runs->count);
+    if (!file)
+        return -1;
+
+    int status = 0;
+    for (Node *current = head; current && status == 0; current = current->next)
+        status = write_record(file, current->data, codec, scratch);
+    if (close_run(runs, file, status) != 0)
+        return -1;
+
+    retire_chain(list, head);
+    return 0;
+}
+
+// Read runs [first, runs->count) back into a chain, for giving the list its
+// elements back after a failure. Records that cannot be read are lost.
+static Node *read_back_runs(RunSet *runs, size_t first, const Codec *codec,
+                            Buffer *scratch, size_t *count)
+{
+    Node *head = NULL;
+    Node **tail = &head;
+    for (size_t i = first; i < runs->count; i++)
+    {
+        FILE *file = reopen_run(&runs->runs[i]);
+        void *data;
+        while (file && read_record(file, codec, scratch, &data) > 0)
+        {
+            Node *node = create_node(data, NULL);
+            if (!node)
+            {
+                if (codec->free_data)
+                    codec->free_data(data);
+                break;
+            }
+            *tail = node;
+            tail = &node->next;
+            (*count)++;
+        }
+        if (file)
+            fclose(file);
+    }
+    return head;
+}
+
+// Give the list back every element after a failure before the final merge:
+// those of the remaining runs, then the chains still in memory
+static void restore_list(LinkedList *list, RunSet *runs, size_t first,
+                         const Codec *codec, Buffer *scratch, Node *pending,
+                         Node *rest)
+{
+    size_t count = 0;
+    Node *head = read_back_runs(runs, first, codec, scratch, &count);
+    append_chain(list, head, count);
+
+    Node *chains[] = {pending, rest};
+    for (int i = 0; i < 2; i++)
+    {
+        count = 0;
+        for (Node *current = chains[i]; current; current = current->next)
+            count++;
+        append_chain(list, chains[i], count);
+    }
+}
+
+/**
+ * @brief Sort a linked list under a memory budget, streaming the result.
+ *
+ * The list is cut into chunks whose serialized payloads fit in
+ * `mem_budget` bytes. Each chunk is sorted in memory with sort(), written to
+ * a temporary run file with buffered sequential writes, and its payloads are
+ * freed. The runs are then merged k ways with a heap and every payload is
+ * handed, in sorted order, to `consumer`, which takes ownership of it. When
+ * the whole list fits in the budget nothing is written to disk and the
+ * original payloads are handed over directly. The sort is stable.
+ *
+ * At most MAX_FAN_IN + 1 temporary files are open at once, whatever the
+ * number of runs. On success, the list is left empty. If a temporary file
+ * cannot be written or the runs cannot be merged, nothing has been handed to
+ * `consumer` yet and the list gets all of its elements back, those of the
+ * spilled chunks read back from disk, though not in their original order. If
+ * the runs cannot be read during the final merge, the payloads that were not
+ * handed to `consumer` yet are freed with the free_data function of the list.
+ *
+ * @param[in] list Pointer to the linked list to sort.
+ * @param[in] cmp Comparison function that returns <0, 0, or >0 based on
+ * element comparison.
+ * @param[in] serialize Function writing the bytes of one payload, called as
+ * `serialize(data, buffer, capacity)`. It returns the number of bytes needed
+ * and only writes them when they fit in `capacity`.
+ * @param[in] deserialize Function rebuilding a payload from its bytes.
+ * @param[in] mem_budget Maximum number of serialized bytes kept in memory
+ * for one chunk.
+ * @param[in] tmpdir Directory of the temporary files, or NULL for /tmp.
+ * @param[in] consumer Function receiving the payloads in sorted order.
+ * @param[in] context Opaque pointer passed to `consumer`.
+ * @return 0 on success, -1 if a temporary file could not be used or memory
+ * allocation fails.
+ */
+int external_sort_stream(LinkedList *list,
+                         int (*cmp)(const void *, const void *),
+                         size_t (*serialize)(const void *data, void *buffer,
+                                             size_t capacity),
+                         void *(*deserialize)(const void *buffer, size_t size),
+                         size_t mem_budget, const char *tmpdir,
+                         void (*consumer)(void *data, void *context),
+                         void *context)
+{
+    if (list_unshare(list) != 0)
+        return -1;
+
+    Codec codec = {cmp, serialize, deserialize, list->free_data, tmpdir};
+    RunSet runs = {NULL, 0, 0};
+    Buffer scratch = {NULL, 0};
+    Node *head = take_nodes(list);
+    Node *pending = NULL; // sorted chunk that could not be spilled
+    int status = 0;
+
+    while (head && status == 0)
+    {
+        Node *chunk = head;
+        Node *last = NULL;
+        size_t count = 0;
+        size_t bytes = 0;
+        while (head)
+        {
+            size_t size = serialize(head->data, NULL, 0);
+            if (count && bytes + size > mem_budget)
+                break;
+            bytes += size;
+            count++;
+            last = head;
+            head = head->next;
+        }
+        last->next = NULL;
+        chunk = sort_chain(chunk, count, &codec);
+
+        if (!head && runs.count == 0)
+        {
+            // Everything fits in the budget: no need to touch the disk
+            while (chunk)
+            {
+                Node *next = chunk->next;
+                consumer(chunk->data, context);
+                free_node(chunk);
+                chunk = next;
+            }
+            break;
+        }
+        status = spill_chain(list, &runs, chunk, &codec, &scratch);
+        if (status != 0)
+            pending = chunk;
+    }
+
+    // Merge passes until the remaining runs can be opened at once. Each pass
+    // merges the oldest runs into a new one, keeping the rank of the first.
+    size_t first = 0;
+    while (status == 0 && runs.count - first > MAX_FAN_IN)
+    {
+        size_t group = runs.count - first < 2 * MAX_FAN_IN
+            ? runs.count - first - MAX_FAN_IN + 1
+            : MAX_FAN_IN;
+        size_t rank = runs.runs[first].rank;
+        for (size_t i = first; i < first + group; i++)
+        {
+            if (runs.runs[i].rank < rank)
+                rank = runs.runs[i].rank;
+        }
+
+        // The merged run is only kept, and its sources removed, once it is
+        // complete, so that a failure loses nothing
+        RunWriter writer = {open_run(&runs, tmpdir, rank), &codec, &scratch};
+        if (!writer.file)
+        {
+            status = -1;
+            break;
+        }
+        status = merge_runs(runs.runs + first, group, &codec, &scratch,
+                            emit_to_run, &writer);
+        status = close_run(&runs, writer.file, status);
+        if (status == 0)
+        {
+            remove_runs(runs.runs, first, first + group);
+            first += group;
+        }
+    }
+
+    if (status != 0)
+    {
+        restore_list(list, &runs, first, &codec, &scratch, pending, head);
+    }
+    else if (runs.count > first)
+    {
+        Consumer sink = {consumer, context};
+        status = merge_runs(runs.runs + first, runs.count - first, &codec,
+                            &scratch, emit_to_consumer, &sink);
+    }
+
+    remove_runs(runs.runs, first, runs.count);
+    free(runs.runs);
+    free(scratch.bytes);
+    return status;
+}
+
+typedef struct ListAppender
+{
+    LinkedList *list;
+    Node **tail;
+} ListAppender;
+
+static void append_to_tail(void *data, void *context)
+{
+    ListAppender *appender = context;
+    Node *node = create_node(data, NULL);
+    if (!node)
+    {
+        retire_data(appender->list, data);
+        return;
+    }
+    *appender->tail = node;
+    appender->tail = &node->next;
+    appender->list->size++;
+}
+
+// Whether the serialized payloads of the whole list fit in the budget, in
+// which case external_sort_stream would not spill anything either
+static int fits_in_budget(LinkedList *list,
+                          size_t (*serialize)(const void *, void *, size_t),
+                          size_t mem_budget)
+{
+    size_t bytes = 0;
+    for (Node *current = list->head; current; current = current->next)
+    {
+        bytes += serialize(current->data, NULL, 0);
+        if (bytes > mem_budget && current != list->head)
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Sort a linked list under a memory budget.
+ *
+ * When the whole list fits in the budget, it is simply sorted in place with
+ * sort(). Otherwise this is external_sort_stream rebuilding the list itself:
+ * once sorted, the list holds the payloads returned by `deserialize`, which
+ * it frees with its free_data function like any other payload. The original
+ * payloads of spilled chunks are freed along the way.
+ *
+ * @param[in] list Pointer to the linked list to sort.
+ * @param[in] cmp Comparison function that returns <0, 0, or >0 based on
+ * element comparison.
+ * @param[in] serialize Function writing the bytes of one payload.
+ * @param[in] deserialize Function rebuilding a payload from its bytes.
+ * @param[in] mem_budget Maximum number of serialized bytes kept in memory
+ * for one chunk.
+ * @param[in] tmpdir Directory of the temporary files, or NULL for /tmp.
+ * @return 0 on success, -1 on failure. If the failure happened before the
+ * final merge, the list holds all of its elements again, as for
+ * external_sort_stream; otherwise it holds the elements sorted so far.
+ */
+int external_sort(LinkedList *list, int (*cmp)(const void *, const void *),
+                  size_t (*serialize)(const void *data, void *buffer,
+                                      size_t capacity),
+                  void *(*deserialize)(const void *buffer, size_t size),
+                  size_t mem_budget, const char *tmpdir)
+{
+    if (fits_in_budget(list, serialize, mem_budget))
+    {
+        sort(list, cmp);
+        return 0;
+    }
+
+    Node *sorted = NULL;
+    ListAppender appender = {list, &sorted};
+    int status = external_sort_stream(list, cmp, serialize, deserialize,
+                                      mem_budget, tmpdir, append_to_tail,
+                                      &appender);
+    if (sorted)
+    {
+        list->head = sorted;
+        hash_index_rebuild(list);
+    }
+    return status;
+}
@@ -0,0 +1,291 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "linked_list.h"
+
+#define MIN_SLOTS 16
+
+// The index grows once it is 70% full, which keeps linear probes short
+#define MAX_LOAD_NUM 7
+#define MAX_LOAD_DEN 10
+
+// Spread the user hash over all the bits used to pick a slot, so that
+// sequential keys do not fill neighbouring slots
+static size_t mix_hash(size_t hash)
+{
+    uint64_t x = (uint64_t)hash;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return (size_t)x;
+}
+
+// Insert a node known to be absent into a table with a free slot
+static void place_node(HashSlot *slots, size_t capacity, size_t hash,
+                       Node *node)
+{
+    size_t mask = capacity - 1;
+    size_t i = hash & mask;
+    while (slots[i].node)
+        i = (i + 1) & mask;
+    slots[i].hash = hash;
+    slots[i].node = node;
+}
+
+// Fill a table of `capacity` slots with every node of the list, or mark the
+// index as stale if it cannot be allocated
+static void fill_index(LinkedList *list, size_t capacity)
+{
+    HashIndex *index = list->hash_index;
+    HashSlot *slots = calloc(capacity, sizeof(HashSlot));
+    free(index->slots);
+    index->slots = slots;
+    index->count = 0;
+    index->capacity = slots ? capacity : 0;
+    if (!slots)
+        return;
+
+    for (Node *current = list->head; current; current = current->next)
+    {
+        place_node(slots, capacity, mix_hash(index->hash(current->data)),
+                   current);
+        index->count++;
+    }
+}
+
+// Smallest table keeping `count` entries under the maximum load
+static size_t capacity_for(size_t count)
+{
+    size_t capacity = MIN_SLOTS;
+    while (count * MAX_LOAD_DEN >= capacity * MAX_LOAD_NUM)
+        capacity *= 2;
+    return capacity;
+}
+
+/**
+ * @brief Rebuild the hash index of the list from its nodes.
+ *
+ * Called whenever the nodes of the list were replaced rather than added or
+ * removed one at a time.
+ *
+ * @param list Pointer to the linked list, with or without an index.
+ */
+void hash_index_rebuild(LinkedList *list)
+{
+    if (list->hash_index)
+        fill_index(list, capacity_for(list->size));
+}
+
+/**
+ * @brief Add a node just linked into the list to its hash index.
+ *
+ * @param list Pointer to the linked list, with or without an index.
+ * @param node The new node.
+ */
+void hash_index_insert(LinkedList *list, Node *node)
+{
+    HashIndex *index = list->hash_index;
+    if (!index || !index->slots)
+        return;
+
+    if ((index->count + 1) * MAX_LOAD_DEN >= index->capacity * MAX_LOAD_NUM)
+    {
+        // The node is already linked, so the rebuild picks it up
+        fill_index(list, index->capacity * 2);
+        return;
+    }
+    place_node(index->slots, index->capacity, mix_hash(index->hash(node->data)),
+               node);
+    index->count++;
+}
+
+// Find the slot holding `node`, whose hash is `hash`
+static size_t find_slot(HashIndex *index, size_t hash, Node *node)
+{
+    size_t mask = index->capacity - 1;
+    size_t i = hash & mask;
+    while (index->slots[i].node != node)
+        i = (i + 1) & mask;
+    return i;
+}
+
+/**
+ * @brief Remove a node about to be unlinked from the hash index of the list.
+ *
+ * Linear probing allows deleting without tombstones: the entries following
+ * the freed slot in the same cluster are shifted back when their home slot
+ * does not lie between the freed slot and their current one.
+ *
+ * @param list Pointer to the linked list, with or without an index.
+ * @param node The node to remove. It must still hold its data.
+ */
+void hash_index_remove(LinkedList *list, Node *node)
+{
+    HashIndex *index = list->hash_index;
+    if (!index || !index->slots)
+        return;
+
+    size_t mask = index->capacity - 1;
+    size_t hole = find_slot(index, mix_hash(index->hash(node->data)), node);
+    for (size_t i = (hole + 1) & mask; index->slots[i].node;
+         i = (i + 1) & mask)
+    {
+        size_t home = index->slots[i].hash & mask;
+        // Move the entry back unless its home lies in (hole, i]
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            index->slots[hole] = index->slots[i];
+            hole = i;
+        }
+    }
+    index->slots[hole].node = NULL;
+    index->count--;
+}
+
+/**
+ * @brief Record that a node now holds the data of another node.
+ *
+ * @param list Pointer to the linked list, with or without an index.
+ * @param from The node the data was indexed under.
+ * @param to The node now holding the data.
+ */
+void hash_index_move(LinkedList *list, Node *from, Node *to)
+{
+    HashIndex *index = list->hash_index;
+    if (!index || !index->slots)
+        return;
+    size_t hash = mix_hash(index->hash(to->data));
+    index->slots[find_slot(index, hash, from)].node = to;
+}
+
+/**
+ * @brief Find a node holding an element equal to `key`.
+ *
+ * Stale indexes, left by a failed allocation, are rebuilt first. If that
+ * fails again, the list is scanned. Without an index, elements are compared
+ * to the key by address.
+ *
+ * @param list Pointer to the linked list, with or without an index.
+ * @param key The key to look up.
+ * @return The node, or NULL if no element matches.
+ */
+Node *hash_index_lookup(LinkedList *list, const void *key)
+{
+    HashIndex *index = list->hash_index;
+    if (!index)
+    {
+        for (Node *current = list->head; current; current = current->next)
+        {
+            if (current->data == key)
+                return current;
+        }
+        return NULL;
+    }
+
+    if (!index->slots)
+        hash_index_rebuild(list);
+
+    if (!index->slots)
+    {
+        for (Node *current = list->head; current; current = current->next)
+        {
+            if (index->eq(current->data, key))
+                return current;
+        }
+        return NULL;
+    }
+
+    size_t hash = mix_hash(index->hash(key));
+    size_t mask = index->capacity - 1;
+    for (size_t i = hash & mask; index->slots[i].node; i = (i + 1) & mask)
+    {
+        if (index->slots[i].hash == hash
+            && index->eq(index->slots[i].node->data, key))
+            return index->slots[i].node;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Attach a hash index to the linked list.
+ *
+ * Once attached, the index follows every change to the list and makes
+ * list_find, list_contains and list_remove_key O(1) on average instead of a
+ * scan. Elements must not be modified in a way that changes their hash while
+ * they are in the list. Attaching an index again replaces the previous one.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @param[in] hash Function hashing an element. Equal elements must have the
+ * same hash.
+ * @param[in] eq Function returning non-zero when two elements are equal.
+ * @return 0 on success, or -1 if memory allocation fails.
+ */
+int list_attach_index(LinkedList *list, size_t (*hash)(const void *data),
+                      int (*eq)(const void *a, const void *b))
+{
+    if (!list || !hash || !eq)
+        return -1;
+
+    list_detach_index(list);
+    list->hash_index = malloc(sizeof(HashIndex));
+    if (!list->hash_index)
+        return -1;
+    list->hash_index->hash = hash;
+    list->hash_index->eq = eq;
+    list->hash_index->slots = NULL;
+    hash_index_rebuild(list);
+    if (!list->hash_index->slots)
+    {
+        list_detach_index(list);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Remove the hash index of the linked list, if any.
+ *
+ * @param[in] list Pointer to the linked list.
+ */
+void list_detach_index(LinkedList *list)
+{
+    if (!list || !list->hash_index)
+        return;
+    free(list->hash_index->slots);
+    free(list->hash_index);
+    list->hash_index = NULL;
+}
+
+/**
+ * @brief Find an element equal to `key` in the linked list.
+ *
+ * With a hash index attached, this is O(1) on average and returns one of the
+ * matching elements. Without one, this scans the list and returns the first
+ * match.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @param[in] key Element to look for, compared with the `eq` function given
+ * to list_attach_index, which `key` must also be valid for. Without an index,
+ * the key is compared by address.
+ * @return Pointer to the matching element, or NULL if there is none.
+ */
+void *list_find(LinkedList *list, const void *key)
+{
+    if (!list)
+        return NULL;
+
+    Node *node = hash_index_lookup(list, key);
+    return node ? node->data : NULL;
+}
+
+/**
+ * @brief Check whether the linked list holds an element equal to `key`.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @param[in] key Element to look for, as for list_find.
+ * @return 1 if a matching element is found, 0 otherwise.
+ */
+int list_contains(LinkedList *list, const void *key)
+{
+    return list && hash_index_lookup(list, key) != NULL;
+}
@@ -0,0 +1,253 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "linked_list.h"
+
+// Size of the reads from file descriptors; lines longer than this grow the
+// buffer
+#define READ_CHUNK (1 << 20)
+// Nodes are allocated in blocks, starting small so that short inputs do not
+// pin a large block, and doubling up to this size
+#define MIN_NODE_BATCH 64
+#define MAX_NODE_BATCH 4096
+
+typedef void *(*LineParser)(const char *line, size_t length, void *context);
+
+// Chain of new nodes built apart from the list, and linked to it at the end
+typedef struct ChainBuilder
+{
+    Node *head;
+    Node **tail;
+    size_t count;
+    Node *spare; // unused nodes of the current block
+    size_t spare_count;
+    size_t batch;
+} ChainBuilder;
+
+static void builder_init(ChainBuilder *builder)
+{
+    builder->head = NULL;
+    builder->tail = &builder->head;
+    builder->count = 0;
+    builder->spare = NULL;
+    builder->spare_count = 0;
+    builder->batch = MIN_NODE_BATCH;
+}
+
+static int builder_add(ChainBuilder *builder, void *data)
+{
+    if (builder->spare_count == 0)
+    {
+        builder->spare = create_node_block(builder->batch);
+        if (!builder->spare)
+            return -1;
+        builder->spare_count = builder->batch;
+        if (builder->batch < MAX_NODE_BATCH)
+            builder->batch *= 2;
+    }
+
+    Node *node = builder->spare;
+    builder->spare = node->next;
+    builder->spare_count--;
+    node->data = data;
+    node->next = NULL;
+    *builder->tail = node;
+    builder->tail = &node->next;
+    builder->count++;
+    return 0;
+}
+
+// Give back the nodes of the last block that were not used
+static void builder_release_spare(ChainBuilder *builder)
+{
+    while (builder->spare_count > 0)
+    {
+        Node *node = builder->spare;
+        builder->spare = node->next;
+        free_node(node);
+        builder->spare_count--;
+    }
+}
+
+// Hand every complete line of [data, data + length) to the parser, and the
+// trailing unterminated one too when `final` is set. Returns the number of
+// bytes consumed, or -1 if memory allocation fails, in which case the element
+// that could not be linked is freed with `free_data`.
+static ssize_t parse_lines(ChainBuilder *builder, const char *data,
+                           size_t length, int final, LineParser parse,
+                           void *context, void (*free_data)(void *))
+{
+    const char *start = data;
+    const char *end = data + length;
+    while (start < end)
+    {
+        const char *newline = memchr(start, '\n', end - start);
+        if (!newline && !final)
+            break;
+
+        const char *line_end = newline ? newline : end;
+        void *element = parse(start, line_end - start, context);
+        if (element && builder_add(builder, element) != 0)
+        {
+            if (free_data)
+                free_data(element);
+            return -1;
+        }
+        start = newline ? newline + 1 : end;
+    }
+    return start - data;
+}
+
+// Link the parsed elements to the list, or free them all on failure
+static ssize_t finish_ingest(LinkedList *list, ChainBuilder *builder,
+                             int status)
+{
+    builder_release_spare(builder);
+    if (status != 0)
+    {
+        free_chain(builder->head, list->free_data);
+        return -1;
+    }
+    append_chain(list, builder->head, builder->count);
+    return (ssize_t)builder->count;
+}
+
+/**
+ * @brief Append the records of a newline-delimited stream to the list.
+ *
+ * The descriptor is read in large chunks until end of file, and every line,
+ * without its newline, is handed to `parse` as a slice of the read buffer,
+ * so nothing is copied on the way. The elements returned by `parse` are
+ * linked in nodes allocated in blocks, then appended to the list in one
+ * step. A last line without a newline is parsed too.
+ *
+ * @param[in] list Pointer to the linked list receiving the elements.
+ * @param[in] fd File descriptor to read from, which is not closed.
+ * @param[in] parse Function building an element from a line, or returning
+ * NULL to skip it. The line is not NUL-terminated and is only valid during
+ * the call, so anything kept from it must be copied.
+ * @param[in] context Pointer passed through to `parse`.
+ * @return The number of elements appended, or -1 if reading fails or memory
+ * allocation fails, in which case the parsed elements are freed with the
+ * list's free_data function and the list is left unchanged.
+ */
+ssize_t list_ingest_fd(LinkedList *list, int fd,
+                       void *(*parse)(const char *line, size_t length,
+                                      void *context),
+                       void *context)
+{
+    if (!list || !parse || list_unshare(list) != 0)
+        return -1;
+
+    size_t capacity = READ_CHUNK;
+    char *buffer = malloc(capacity);
+    if (!buffer)
+        return -1;
+
+    ChainBuilder builder;
+    builder_init(&builder);
+
+    size_t pending = 0; // bytes of an incomplete line kept at the start
+    int status = 0;
+    for (;;)
+    {
+        if (capacity - pending < READ_CHUNK / 2)
+        {
+            char *grown = realloc(buffer, capacity * 2);
+            if (!grown)
+            {
+                status = -1;
+                break;
+            }
+            buffer = grown;
+            capacity *= 2;
+        }
+
+        ssize_t bytes = read(fd, buffer + pending, capacity - pending);
+        if (bytes < 0 && errno == EINTR)
+            continue;
+        if (bytes < 0)
+        {
+            status = -1;
+            break;
+        }
+
+        size_t length = pending + (size_t)bytes;
+        ssize_t consumed = parse_lines(&builder, buffer, length, bytes == 0,
+                                       parse, context, list->free_data);
+        if (consumed < 0)
+        {
+            status = -1;
+            break;
+        }
+        pending = length - (size_t)consumed;
+        if (bytes == 0)
+            break;
+        memmove(buffer, buffer + consumed, pending);
+    }
+
+    free(buffer);
+    return finish_ingest(list, &builder, status);
+}
+
+/**
+ * @brief Append the records of a newline-delimited file to the list.
+ *
+ * This works like list_ingest_fd, but maps the whole file and hands the
+ * parser slices of the mapping, which saves copying the data out of the
+ * page cache. The mapping is released before returning.
+ *
+ * @param[in] list Pointer to the linked list receiving the elements.
+ * @param[in] path Path of the file to read.
+ * @param[in] parse Function building an element from a line, or returning
+ * NULL to skip it. The line is not NUL-terminated and is only valid during
+ * the call.
+ * @param[in] context Pointer passed through to `parse`.
+ * @return The number of elements appended, or -1 if the file cannot be
+ * mapped or memory allocation fails, in which case the list is left
+ * unchanged.
+ */
+ssize_t list_ingest_mmap(LinkedList *list, const char *path,
+                         void *(*parse)(const char *line, size_t length,
+                                        void *context),
+                         void *context)
+{
+    if (!list || !parse || list_unshare(list) != 0)
+        return -1;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    if (info.st_size == 0)
+    {
+        close(fd);
+        return 0;
+    }
+
+    size_t size = (size_t)info.st_size;
+    char *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return -1;
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    ChainBuilder builder;
+    builder_init(&builder);
+    ssize_t consumed =
+        parse_lines(&builder, map, size, 1, parse, context, list->free_data);
+
+    munmap(map, size);
+    return finish_ingest(list, &builder, consumed < 0 ? -1 : 0);
+}
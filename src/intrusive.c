@@ -0,0 +1,292 @@
+#include <stdlib.h>
+
+#include "../include/utils.h"
+
+#define SORT_NODE ListLink
+#define SORT_KEY(link) (link)
+#define SORT_NAME(name) link_##name
+#include "merge_sort.h"
+
+/*
+ * Intrusive containers chain the user's own structs through an embedded
+ * ListLink instead of wrapping them in nodes, so none of the functions below
+ * allocate. A link can be in at most one container at a time, and the
+ * containers never free anything themselves: free_intrusive_list and
+ * free_intrusive_stack hand every link to a callback that releases the
+ * enclosing struct.
+ */
+
+/**
+ * @brief Initialize an empty intrusive list.
+ *
+ * @param[in] list Pointer to the list, usually embedded in a larger struct.
+ */
+void init_intrusive_list(IntrusiveList *list)
+{
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+}
+
+/**
+ * @brief Append a link at the end of the intrusive list in O(1).
+ *
+ * @param[in] list Pointer to the intrusive list.
+ * @param[in] link Link embedded in the element to append.
+ */
+void list_link_append(IntrusiveList *list, ListLink *link)
+{
+    link->next = NULL;
+    if (list->tail)
+        list->tail->next = link;
+    else
+        list->head = link;
+    list->tail = link;
+    list->size++;
+}
+
+/**
+ * @brief Insert a link at a specified position in the intrusive list.
+ *
+ * @param[in] list Pointer to the intrusive list.
+ * @param[in] link Link embedded in the element to insert.
+ * @param[in] position The position at which to insert the element (0-based
+ * index). If position is greater than the size of the list, the element is
+ * appended.
+ */
+void list_link_insert_at(IntrusiveList *list, ListLink *link,
+                         size_t position)
+{
+    if (position >= list->size)
+    {
+        list_link_append(list, link);
+        return;
+    }
+
+    ListLink **slot = &list->head;
+    for (size_t i = 0; i < position; i++)
+        slot = &(*slot)->next;
+    link->next = *slot;
+    *slot = link;
+    list->size++;
+}
+
+/**
+ * @brief Unlink the element at a specified position in the intrusive list.
+ *
+ * @param[in] list Pointer to the intrusive list.
+ * @param[in] position The position of the element to remove (0-based index).
+ * @return The link of the removed element, which the caller owns again, or
+ * NULL if the position is out of bounds.
+ */
+ListLink *list_link_remove_at(IntrusiveList *list, size_t position)
+{
+    if (position >= list->size)
+        return NULL;
+
+    ListLink *previous = NULL;
+    ListLink **slot = &list->head;
+    for (size_t i = 0; i < position; i++)
+    {
+        previous = *slot;
+        slot = &(*slot)->next;
+    }
+
+    ListLink *link = *slot;
+    *slot = link->next;
+    if (list->tail == link)
+        list->tail = previous;
+    link->next = NULL;
+    list->size--;
+    return link;
+}
+
+/**
+ * @brief Get the link at a specified position in the intrusive list.
+ *
+ * @param[in] list Pointer to the intrusive list.
+ * @param[in] position The position of the element (0-based index).
+ * @return The link of the element, or NULL if the position is out of bounds.
+ */
+ListLink *list_link_get_at(IntrusiveList *list, size_t position)
+{
+    if (position >= list->size)
+        return NULL;
+
+    ListLink *current = list->head;
+    for (size_t i = 0; i < position; i++)
+        current = current->next;
+    return current;
+}
+
+/**
+ * @brief Apply a function to each link of the intrusive list, in order.
+ *
+ * @param[in] list Pointer to the intrusive list.
+ * @param[in] func Function called with the link of each element. It must not
+ * unlink the element.
+ */
+void list_link_foreach(IntrusiveList *list, void (*func)(ListLink *link))
+{
+    for (ListLink *current = list->head; current; current = current->next)
+        func(current);
+}
+
+/**
+ * @brief Sort the intrusive list in place.
+ *
+ * This uses the same stable natural merge sort as sort, relinking the
+ * elements without allocating.
+ *
+ * @param[in] list Pointer to the intrusive list.
+ * @param[in] cmp Comparison function that returns <0, 0, or >0. It receives
+ * two `const ListLink *`, from which container_of gets the elements.
+ */
+void list_link_sort(IntrusiveList *list,
+                    int (*cmp)(const void *a, const void *b))
+{
+    if (list->size < 2)
+        return;
+
+    list->head = link_natural_merge_sort(list->head, cmp);
+    ListLink *tail = list->head;
+    while (tail->next)
+        tail = tail->next;
+    list->tail = tail;
+}
+
+/**
+ * @brief Get the number of elements in the intrusive list.
+ *
+ * @param[in] list Pointer to the intrusive list.
+ * @return The number of elements.
+ */
+size_t list_link_length(IntrusiveList *list)
+{
+    return list ? list->size : 0;
+}
+
+// Hand every link of a chain to free_item, reading the next link first
+static void release_links(ListLink *head, void (*free_item)(ListLink *link))
+{
+    while (head)
+    {
+        ListLink *next = head->next;
+        if (free_item)
+            free_item(head);
+        head = next;
+    }
+}
+
+/**
+ * @brief Empty the intrusive list, releasing each element.
+ *
+ * The list itself is not freed since it is not allocated by the library; it
+ * is left empty and can be reused.
+ *
+ * @param[in] list Pointer to the intrusive list.
+ * @param[in] free_item Function called with the link of each element to free
+ * the enclosing struct, or NULL to only unlink the elements.
+ */
+void free_intrusive_list(IntrusiveList *list,
+                         void (*free_item)(ListLink *link))
+{
+    if (!list)
+        return;
+    release_links(list->head, free_item);
+    init_intrusive_list(list);
+}
+
+/**
+ * @brief Initializes an empty intrusive stack.
+ *
+ * @param stack The stack, usually embedded in a larger struct.
+ */
+void init_intrusive_stack(IntrusiveStack *stack)
+{
+    stack->head = NULL;
+    stack->size = 0;
+}
+
+/**
+ * @brief Pushes an element onto the intrusive stack.
+ *
+ * @param stack The stack on which to push the element.
+ * @param link The link embedded in the element.
+ */
+void stack_link_push(IntrusiveStack *stack, ListLink *link)
+{
+    link->next = stack->head;
+    stack->head = link;
+    stack->size++;
+}
+
+/**
+ * @brief Pops the top element from the intrusive stack.
+ *
+ * @param stack The stack from which to pop the element.
+ * @return ListLink* The link of the popped element, or NULL if the stack is
+ * empty.
+ */
+ListLink *stack_link_pop(IntrusiveStack *stack)
+{
+    ListLink *top = stack->head;
+    if (!top)
+        return NULL;
+    stack->head = top->next;
+    top->next = NULL;
+    stack->size--;
+    return top;
+}
+
+/**
+ * @brief Returns the top element of the intrusive stack without popping it.
+ *
+ * @param stack The stack to inspect.
+ * @return ListLink* The link of the top element, or NULL if the stack is
+ * empty.
+ */
+ListLink *stack_link_peek(IntrusiveStack *stack)
+{
+    return stack->head;
+}
+
+/**
+ * @brief Applies a function to each element, from the top of the stack down.
+ *
+ * @param stack The stack to walk.
+ * @param func The function called with the link of each element. It must not
+ * pop the element.
+ */
+void stack_link_foreach(IntrusiveStack *stack, void (*func)(ListLink *link))
+{
+    for (ListLink *current = stack->head; current; current = current->next)
+        func(current);
+}
+
+/**
+ * @brief Returns the current number of elements in the intrusive stack.
+ *
+ * @param stack The stack whose length is queried.
+ * @return size_t The number of elements in the stack.
+ */
+size_t stack_link_length(IntrusiveStack *stack)
+{
+    return stack ? stack->size : 0;
+}
+
+/**
+ * @brief Empties the intrusive stack, releasing each element.
+ *
+ * @param stack The stack to empty. It is left empty and can be reused.
+ * @param free_item The function called with the link of each element to free
+ * the enclosing struct, or NULL to only unlink the elements.
+ */
+void free_intrusive_stack(IntrusiveStack *stack,
+                          void (*free_item)(ListLink *link))
+{
+    if (!stack)
+        return;
+    release_links(stack->head, free_item);
+    init_intrusive_stack(stack);
+}
@@ -1,14 +1,10 @@
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
-#include "node.h"
-
-struct LinkedList
-{
-    struct Node *head;
-    size_t size;
-    void (*free_data)(void *data);
-};
+#include "linked_list.h"
+#include "memory.h"
+#include "retire.h"
 
 /**
  * @brief Initialize a new linked list.
@@ -31,9 +27,135 @@ LinkedList *init_linked_list(void (*free_data)(void *))
     list->head = NULL;
     list->size = 0;
     list->free_data = free_data;
+    list->sorted_index = NULL;
+    list->churn = 0;
+    list->compact_ratio = 0;
+    list->memory_entry = NULL;
+    list->share = NULL;
+    list->lineage = NULL;
+    list->generation = NULL;
+    list->hash_index = NULL;
     return list;
 }
 
+// Forget the sparse index once the order of the nodes may have changed
+static void drop_sorted_index(LinkedList *list)
+{
+    free(list->sorted_index);
+    list->sorted_index = NULL;
+}
+
+/**
+ * @brief Detach the node chain of the list, leaving the list empty.
+ *
+ * The caller becomes responsible for the returned nodes and their data. The
+ * list must not share its chain with clones, see list_unshare.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @return The first node of the chain, or NULL if the list was empty.
+ */
+Node *take_nodes(LinkedList *list)
+{
+    drop_sorted_index(list);
+    Node *head = list->head;
+    list->head = NULL;
+    list->size = 0;
+    hash_index_rebuild(list);
+    return head;
+}
+
+/**
+ * @brief Give the list a private copy of a chain shared with clones.
+ *
+ * Every function that relinks, adds or releases nodes calls this first. The
+ * copy is laid out in a single block; when the list turns out to be the last
+ * one using the shared chain, it simply keeps it.
+ *
+ * @param list Pointer to the linked list.
+ * @return 0 on success, or -1 if memory allocation fails, in which case the
+ * list still shares its chain.
+ */
+int list_unshare(LinkedList *list)
+{
+    struct ChainShare *share = list->share;
+    if (!share)
+        return 0;
+
+    if (atomic_load(&share->refs) > 1)
+    {
+        Node *nodes = NULL;
+        if (list->size)
+        {
+            nodes = create_node_block(list->size);
+            if (!nodes)
+                return -1;
+        }
+
+        size_t index = 0;
+        for (Node *current = list->head; current; current = current->next)
+            nodes[index++].data = current->data;
+
+        Node *shared = list->head;
+        drop_sorted_index(list);
+        list->head = nodes;
+        list->share = NULL;
+        list->churn = 0;
+        hash_index_rebuild(list);
+        if (atomic_fetch_sub(&share->refs, 1) > 1)
+            return 0;
+        free_chain(shared, NULL);
+    }
+    free(share);
+    list->share = NULL;
+    return 0;
+}
+
+/**
+ * @brief Link a chain of nodes at the end of the list in one step.
+ *
+ * The list must not share its chain with clones, see list_unshare.
+ *
+ * @param list Pointer to the linked list.
+ * @param head First node of the chain, whose last node links to NULL.
+ * @param count Number of nodes in the chain.
+ */
+void append_chain(LinkedList *list, Node *head, size_t count)
+{
+    if (!head)
+        return;
+
+    Node **link = &list->head;
+    while (*link)
+        link = &(*link)->next;
+    *link = head;
+    list->size += count;
+    drop_sorted_index(list);
+    hash_index_rebuild(list);
+}
+
+// Insertions keep the sampled nodes valid but widen the gaps between them,
+// so the index is only kept until a stride's worth of nodes has been added
+static void note_sorted_insertion(LinkedList *list)
+{
+    struct SortedIndex *index = list->sorted_index;
+    if (index && ++index->additions > index->stride)
+        drop_sorted_index(list);
+}
+
+// Below this many insertions and removals, automatic compaction is not worth
+// the copy even on small lists
+#define AUTO_COMPACT_MIN_CHURN 32
+
+// Count an insertion or removal, and compact the list once the configured
+// share of it has been churned since the last compaction
+static void note_churn(LinkedList *list)
+{
+    list->churn++;
+    if (list->compact_ratio > 0 && list->churn >= AUTO_COMPACT_MIN_CHURN &&
+        list->churn >= list->compact_ratio * list->size)
+        list_compact(list);
+}
+
 /**
  * @brief Append a node at the end of the linked list.
  *
@@ -46,11 +168,12 @@ LinkedList *init_linked_list(void (*free_data)(void *))
  */
 void append(LinkedList *list, void *data)
 {
-    Node *new_node = malloc(sizeof(Node));
+    if (list_unshare(list) != 0)
+        return;
+
+    Node *new_node = create_node(data, NULL);
     if (!new_node)
         return;
-    new_node->data = data;
-    new_node->next = NULL;
 
     if (!list->head)
     {
@@ -66,6 +189,9 @@ void append(LinkedList *list, void *data)
         current->next = new_node;
     }
     list->size++;
+    hash_index_insert(list, new_node);
+    note_sorted_insertion(list);
+    note_churn(list);
 }
 
 /**
@@ -84,10 +210,12 @@ void append(LinkedList *list, void *data)
  */
 void insert_at(LinkedList *list, void *data, size_t position)
 {
-    Node *new_node = malloc(sizeof(Node));
+    if (list_unshare(list) != 0)
+        return;
+
+    Node *new_node = create_node(data, NULL);
     if (!new_node)
         return;
-    new_node->data = data;
 
     if (position == 0 || !list->head)
     {
@@ -109,6 +237,9 @@ void insert_at(LinkedList *list, void *data, size_t position)
         current->next = new_node;
     }
     list->size++;
+    hash_index_insert(list, new_node);
+    note_sorted_insertion(list);
+    note_churn(list);
 }
 
 /**
@@ -123,19 +254,18 @@ void insert_at(LinkedList *list, void *data, size_t position)
  */
 void remove_at(LinkedList *list, size_t position)
 {
-    if (!list->head || position >= list->size)
+    if (!list->head || position >= list->size || list_unshare(list) != 0)
         return;
 
+    drop_sorted_index(list);
     Node *current = list->head;
 
     if (position == 0)
     {
         list->head = current->next;
-        if (list->free_data)
-        {
-            list->free_data(current->data);
-        }
-        free(current);
+        hash_index_remove(list, current);
+        retire_data(list, current->data);
+        free_node(current);
     }
     else
     {
@@ -151,14 +281,63 @@ void remove_at(LinkedList *list, size_t position)
         if (current)
         {
             previous->next = current->next;
-            if (list->free_data)
-            {
-                list->free_data(current->data);
-            }
-            free(current);
+            hash_index_remove(list, current);
+            retire_data(list, current->data);
+            free_node(current);
         }
     }
     list->size--;
+    note_churn(list);
+}
+
+/**
+ * @brief Remove an element equal to `key` from the linked list.
+ *
+ * With a hash index attached, the element is found in O(1) on average. It is
+ * then removed in O(1) by moving the next element into its node and
+ * releasing the next node instead, except for the last element, whose
+ * predecessor has to be found by walking the list. The element is freed with
+ * the list's free_data function.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @param[in] key Element to remove, as for list_find.
+ * @return 1 if an element was removed, 0 if none matches, or -1 if memory
+ * allocation fails.
+ */
+int list_remove_key(LinkedList *list, const void *key)
+{
+    if (!list)
+        return 0;
+    if (list_unshare(list) != 0)
+        return -1;
+
+    Node *node = hash_index_lookup(list, key);
+    if (!node)
+        return 0;
+
+    drop_sorted_index(list);
+    hash_index_remove(list, node);
+    retire_data(list, node->data);
+
+    Node *next = node->next;
+    if (next)
+    {
+        node->data = next->data;
+        node->next = next->next;
+        hash_index_move(list, next, node);
+        free_node(next);
+    }
+    else
+    {
+        Node **link = &list->head;
+        while (*link != node)
+            link = &(*link)->next;
+        *link = NULL;
+        free_node(node);
+    }
+    list->size--;
+    note_churn(list);
+    return 1;
 }
 
 /**
@@ -201,9 +380,13 @@ void *get_at(LinkedList *list, size_t position)
  */
 void foreach(LinkedList *list, void (*func)(void *))
 {
+    Prefetcher prefetcher;
+    prefetcher_init(&prefetcher, list->head);
+
     Node *current = list->head;
     while (current != NULL)
     {
+        prefetcher_step(&prefetcher);
         func(current->data);
         current = current->next;
     }
@@ -278,17 +461,187 @@ LinkedList *filter(LinkedList *list, int (*predicate)(void *))
     return new_list;
 }
 
-static Node *merge(Node *left, Node *right,
-                   int (*cmp)(const void *, const void *));
-static Node *merge_sort(Node *head, int (*cmp)(const void *, const void *));
-static Node *split_list(Node *head);
+/**
+ * @brief Split the linked list in two according to a condition, in one pass.
+ *
+ * The nodes are relinked rather than copied: `list` keeps the elements that
+ * satisfy `predicate` and the returned list receives the others, both in
+ * their original order. The returned list uses the same free_data function
+ * and becomes responsible for freeing its elements.
+ *
+ * @param[in] list Pointer to the linked list to split.
+ * @param[in] predicate Function that returns non-zero if an element should
+ * stay in `list`, 0 if it should move to the returned list.
+ * @return A new linked list with the rejected elements, or NULL if memory
+ * allocation fails, in which case `list` is left unchanged.
+ */
+LinkedList *partition(LinkedList *list, int (*predicate)(void *))
+{
+    LinkedList *rejected = init_linked_list(list->free_data);
+    if (!rejected)
+        return NULL;
+    if (list_unshare(list) != 0)
+    {
+        free_linked_list(rejected);
+        return NULL;
+    }
+    retire_adopt(rejected, list);
+
+    Prefetcher prefetcher;
+    prefetcher_init(&prefetcher, list->head);
+
+    Node *current = take_nodes(list);
+    Node **kept_tail = &list->head;
+    Node **rejected_tail = &rejected->head;
+    while (current)
+    {
+        Node *next = current->next;
+        prefetcher_step(&prefetcher);
+        if (predicate(current->data))
+        {
+            *kept_tail = current;
+            kept_tail = &current->next;
+            list->size++;
+        }
+        else
+        {
+            *rejected_tail = current;
+            rejected_tail = &current->next;
+            rejected->size++;
+        }
+        current = next;
+    }
+    *kept_tail = NULL;
+    *rejected_tail = NULL;
+
+    hash_index_rebuild(list);
+    return rejected;
+}
 
 /**
- * @brief Sort the linked list in place using the merge sort algorithm.
+ * @brief Allocate an array of empty linked lists.
+ *
+ * @param count Number of lists.
+ * @param free_data Function pointer given to every list.
+ * @return The array, or NULL if memory allocation fails.
+ */
+LinkedList **init_bucket_lists(size_t count, void (*free_data)(void *))
+{
+    LinkedList **buckets = malloc((count ? count : 1) * sizeof(LinkedList *));
+    if (!buckets)
+        return NULL;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        buckets[i] = init_linked_list(free_data);
+        if (!buckets[i])
+        {
+            while (i-- > 0)
+                free_linked_list(buckets[i]);
+            free(buckets);
+            return NULL;
+        }
+    }
+    return buckets;
+}
+
+/**
+ * @brief Distribute the elements of the linked list into buckets, in one
+ * pass.
+ *
+ * The nodes are relinked rather than copied, and every bucket keeps the
+ * original order of its elements. Afterwards `list` is empty but still has
+ * to be freed by the caller, and each bucket uses the free_data function of
+ * `list` and becomes responsible for freeing its elements.
+ *
+ * @param[in] list Pointer to the linked list to distribute.
+ * @param[in] bucket Function returning the bucket of an element. Values of
+ * `nbuckets` or more are taken modulo `nbuckets`.
+ * @param[in] nbuckets Number of buckets, at least 1.
+ * @return An array of `nbuckets` new linked lists, to be freed with free()
+ * after freeing each list, or NULL if memory allocation fails, in which case
+ * `list` is left unchanged.
+ */
+LinkedList **group_by(LinkedList *list, size_t (*bucket)(void *data),
+                      size_t nbuckets)
+{
+    if (!list || !bucket || nbuckets == 0)
+        return NULL;
+
+    LinkedList **buckets = init_bucket_lists(nbuckets, list->free_data);
+    Node ***tails = malloc(nbuckets * sizeof(Node **));
+    if (!buckets || !tails || list_unshare(list) != 0)
+    {
+        for (size_t i = 0; buckets && i < nbuckets; i++)
+            free_linked_list(buckets[i]);
+        free(buckets);
+        free(tails);
+        return NULL;
+    }
+    for (size_t i = 0; i < nbuckets; i++)
+    {
+        tails[i] = &buckets[i]->head;
+        retire_adopt(buckets[i], list);
+    }
+
+    Prefetcher prefetcher;
+    prefetcher_init(&prefetcher, list->head);
+
+    Node *current = take_nodes(list);
+    while (current)
+    {
+        Node *next = current->next;
+        prefetcher_step(&prefetcher);
+        size_t index = bucket(current->data) % nbuckets;
+        *tails[index] = current;
+        tails[index] = &current->next;
+        buckets[index]->size++;
+        current = next;
+    }
+    for (size_t i = 0; i < nbuckets; i++)
+        *tails[i] = NULL;
+
+    free(tails);
+    return buckets;
+}
+
+/**
+ * @brief Fold every element of the linked list into an accumulator.
+ *
+ * This function walks the list once and computes
+ * combine(...combine(combine(init, d0), d1)..., dn-1). `combine` receives
+ * the current accumulator and the data of one element, and returns the new
+ * accumulator, typically its first argument updated in place. The data of
+ * the list is never modified by the library.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @param[in] init Initial accumulator, returned as is for an empty list.
+ * @param[in] combine Function folding one element into the accumulator.
+ * @return The final accumulator.
+ */
+void *reduce(LinkedList *list, void *init,
+             void *(*combine)(void *acc, void *data))
+{
+    void *acc = init;
+    for (Node *current = list->head; current; current = current->next)
+        acc = combine(acc, current->data);
+    return acc;
+}
+
+#define SORT_NODE Node
+#define SORT_KEY(node) ((node)->data)
+#define SORT_NAME(name) name
+#include "merge_sort.h"
+
+/**
+ * @brief Sort the linked list in place using an adaptive merge sort.
  *
  * This function sorts the linked list in place by modifying the links
- * between nodes. It uses the merge sort algorithm for optimal efficiency on
- * linked lists.
+ * between nodes. It detects the ascending and strictly descending runs
+ * already present in the list in a single pass, then merges them pairwise
+ * with a balanced stack. Random input is sorted in O(n log n), while an
+ * already sorted list is handled in O(n) with n - 1 comparisons. The sort is
+ * stable.
  *
  * @param[in] list Pointer to the linked list to sort.
  * @param[in] cmp Comparison function that returns <0, 0, or >0 based on
@@ -296,78 +649,787 @@ static Node *split_list(Node *head);
  */
 void sort(LinkedList *list, int (*cmp)(const void *, const void *))
 {
-    if (!list || !list->head || list->size < 2)
+    if (!list || !list->head || list->size < 2 || list_unshare(list) != 0)
         return;
-    list->head = merge_sort(list->head, cmp);
+    drop_sorted_index(list);
+    list->head = natural_merge_sort(list->head, cmp);
+}
+
+// Restore the max-heap property by moving heap[index] towards the root
+static void heap_sift_up(Node **heap, size_t index,
+                         int (*cmp)(const void *, const void *))
+{
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / 2;
+        if (cmp(heap[parent]->data, heap[index]->data) >= 0)
+            break;
+        Node *tmp = heap[parent];
+        heap[parent] = heap[index];
+        heap[index] = tmp;
+        index = parent;
+    }
+}
+
+// Restore the max-heap property by moving heap[index] towards the leaves
+static void heap_sift_down(Node **heap, size_t size, size_t index,
+                           int (*cmp)(const void *, const void *))
+{
+    for (;;)
+    {
+        size_t largest = index;
+        size_t left = 2 * index + 1;
+        size_t right = left + 1;
+
+        if (left < size && cmp(heap[left]->data, heap[largest]->data) > 0)
+            largest = left;
+        if (right < size && cmp(heap[right]->data, heap[largest]->data) > 0)
+            largest = right;
+        if (largest == index)
+            break;
+
+        Node *tmp = heap[largest];
+        heap[largest] = heap[index];
+        heap[index] = tmp;
+        index = largest;
+    }
+}
+
+// Select the k smallest nodes with a bounded max-heap, in ascending order.
+// The returned array holds min(k, size) nodes and must be freed by the caller.
+static Node **select_smallest(LinkedList *list, size_t k,
+                              int (*cmp)(const void *, const void *),
+                              size_t *count)
+{
+    if (k > list->size)
+        k = list->size;
+    *count = 0;
+
+    Node **heap = malloc((k ? k : 1) * sizeof(Node *));
+    if (!heap)
+        return NULL;
+
+    size_t size = 0;
+    for (Node *current = list->head; current && k; current = current->next)
+    {
+        if (size < k)
+        {
+            heap[size] = current;
+            heap_sift_up(heap, size++, cmp);
+        }
+        else if (cmp(current->data, heap[0]->data) < 0)
+        {
+            heap[0] = current;
+            heap_sift_down(heap, size, 0, cmp);
+        }
+    }
+
+    // Heap sort in place: move the largest remaining node to the end
+    for (size_t end = size; end > 1; end--)
+    {
+        Node *tmp = heap[0];
+        heap[0] = heap[end - 1];
+        heap[end - 1] = tmp;
+        heap_sift_down(heap, end - 1, 0, cmp);
+    }
+
+    *count = size;
+    return heap;
 }
 
-// Fonction de tri fusion pour les listes chaînées
-static Node *merge_sort(Node *head, int (*cmp)(const void *, const void *))
+/**
+ * @brief Get the k smallest elements of the linked list in sorted order.
+ *
+ * This function scans the list once while keeping the k smallest elements
+ * seen so far in a bounded max-heap, which takes O(n log k) comparisons
+ * instead of sorting the whole list. The original list is left untouched.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @param[in] k Number of elements to select. If k is greater than the size of
+ * the list, every element is returned.
+ * @param[in] cmp Comparison function that returns <0, 0, or >0 based on
+ * element comparison.
+ * @return A new linked list holding the k smallest elements in ascending
+ * order, or NULL if memory allocation fails. The new list shares the data of
+ * the original one and does not free it.
+ */
+LinkedList *top_k(LinkedList *list, size_t k,
+                  int (*cmp)(const void *, const void *))
 {
-    // Cas de base : liste vide ou liste avec un seul élément
-    if (!head || !head->next)
-        return head;
+    LinkedList *result = init_linked_list(NULL);
+    if (!result)
+        return NULL;
 
-    // Diviser la liste en deux sous-listes
-    Node *middle = split_list(head);
-    Node *left = head;
-    Node *right = middle;
+    size_t count;
+    Node **selected = select_smallest(list, k, cmp, &count);
+    if (!selected)
+    {
+        free_linked_list(result);
+        return NULL;
+    }
+
+    Node *nodes = count ? create_node_block(count) : NULL;
+    if (count && !nodes)
+    {
+        free(selected);
+        free_linked_list(result);
+        return NULL;
+    }
+    for (size_t i = 0; i < count; i++)
+        nodes[i].data = selected[i]->data;
+    result->head = nodes;
+    result->size = count;
+
+    free(selected);
+    return result;
+}
+
+// Order node pointers by address so membership can be tested with bsearch
+static int compare_addresses(const void *a, const void *b)
+{
+    uintptr_t left = (uintptr_t) * (Node *const *)a;
+    uintptr_t right = (uintptr_t) * (Node *const *)b;
+    return (left > right) - (left < right);
+}
+
+/**
+ * @brief Move the k smallest elements to the front of the list, sorted.
+ *
+ * This function relinks the list so that its first k nodes are the k smallest
+ * elements in ascending order. The remaining nodes keep their relative order
+ * after them. It runs in O(n log k), which is cheaper than a full sort when
+ * only the beginning of the list is needed.
+ *
+ * @param[in] list Pointer to the linked list to partially sort.
+ * @param[in] k Number of elements to place at the front. If k is greater than
+ * or equal to the size of the list, the whole list is sorted.
+ * @param[in] cmp Comparison function that returns <0, 0, or >0 based on
+ * element comparison.
+ */
+void partial_sort(LinkedList *list, size_t k,
+                  int (*cmp)(const void *, const void *))
+{
+    if (!list || !list->head || k == 0)
+        return;
+    if (k >= list->size)
+    {
+        sort(list, cmp);
+        return;
+    }
+    if (list_unshare(list) != 0)
+        return;
+
+    size_t count;
+    Node **selected = select_smallest(list, k, cmp, &count);
+    if (!selected)
+        return;
+
+    Node **members = malloc(count * sizeof(Node *));
+    if (!members)
+    {
+        free(selected);
+        return;
+    }
+    drop_sorted_index(list);
+    memcpy(members, selected, count * sizeof(Node *));
+    qsort(members, count, sizeof(Node *), compare_addresses);
+
+    // Keep the unselected nodes in their original order
+    Node *rest = NULL;
+    Node **rest_tail = &rest;
+    for (Node *current = list->head; current; current = current->next)
+    {
+        if (!bsearch(&current, members, count, sizeof(Node *),
+                     compare_addresses))
+        {
+            *rest_tail = current;
+            rest_tail = &current->next;
+        }
+    }
+    *rest_tail = NULL;
 
-    // Trier chaque moitié
-    left = merge_sort(left, cmp);
-    right = merge_sort(right, cmp);
+    for (size_t i = 0; i + 1 < count; i++)
+        selected[i]->next = selected[i + 1];
+    selected[count - 1]->next = rest;
+    list->head = selected[0];
 
-    // Fusionner les deux moitiés triées
-    return merge(left, right, cmp);
+    free(members);
+    free(selected);
 }
 
-// Fonction pour diviser la liste en deux à partir du milieu
-static Node *split_list(Node *head)
+// Sample every stride-th node, with stride close to the square root of the
+// size. On allocation failure the list is simply left without an index.
+static void build_sorted_index(LinkedList *list)
 {
-    Node *slow = head;
-    Node *fast = head->next;
+    size_t stride = 1;
+    while ((stride + 1) * (stride + 1) <= list->size)
+        stride++;
+
+    size_t count = (list->size + stride - 1) / stride;
+    struct SortedIndex *index =
+        malloc(sizeof(struct SortedIndex) + count * sizeof(Node *));
+    if (!index)
+        return;
+    index->count = 0;
+    index->stride = stride;
+    index->additions = 0;
 
-    // Utiliser deux pointeurs pour trouver le milieu
-    while (fast && fast->next)
+    size_t skipped = 0;
+    for (Node *current = list->head; current; current = current->next)
     {
-        slow = slow->next;
-        fast = fast->next->next;
+        if (skipped == 0)
+            index->samples[index->count++] = current;
+        skipped = skipped + 1 == stride ? 0 : skipped + 1;
     }
+    list->sorted_index = index;
+}
 
-    Node *middle = slow->next;
-    slow->next = NULL; // Séparer la liste en deux
-    return middle;
+// Binary search the sparse index for the last sampled node ordered before
+// key (or not after it when inclusive is set). NULL means start at the head.
+static Node *sample_before(LinkedList *list, const void *key,
+                           int (*cmp)(const void *, const void *),
+                           int inclusive)
+{
+    struct SortedIndex *index = list->sorted_index;
+    if (!index)
+        return NULL;
+
+    size_t low = 0;
+    size_t high = index->count;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        int order = cmp(index->samples[middle]->data, key);
+        if (order < 0 || (inclusive && order == 0))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low ? index->samples[low - 1] : NULL;
 }
 
-// Fonction pour fusionner deux sous-listes triées
-static Node *merge(Node *left, Node *right,
+/**
+ * @brief Insert an element into a sorted linked list, keeping it sorted.
+ *
+ * This function creates a new node with the provided data and links it after
+ * the last element that does not compare greater, so that equal elements keep
+ * their insertion order. If the sparse index built by find_sorted is present,
+ * it is used to skip most of the list.
+ *
+ * @param[in] list Pointer to the sorted linked list.
+ * @param[in] data Pointer to the data to store in the new node.
+ * @param[in] cmp Comparison function the list is sorted with.
+ */
+void insert_sorted(LinkedList *list, void *data,
                    int (*cmp)(const void *, const void *))
 {
-    // Liste temporaire pour le résultat
-    Node dummy;
-    Node *tail = &dummy;
-    dummy.next = NULL;
+    if (list_unshare(list) != 0)
+        return;
+
+    Node *new_node = create_node(data, NULL);
+    if (!new_node)
+        return;
+
+    Node *previous = sample_before(list, data, cmp, 1);
+    Node **link = previous ? &previous->next : &list->head;
+    while (*link && cmp((*link)->data, data) <= 0)
+        link = &(*link)->next;
+
+    new_node->next = *link;
+    *link = new_node;
+    list->size++;
+    hash_index_insert(list, new_node);
+    note_sorted_insertion(list);
+    note_churn(list);
+}
+
+/**
+ * @brief Merge a sorted linked list into another one.
+ *
+ * This function moves every node of `other` into `list` by relinking them,
+ * without allocating or copying anything. Both lists must be sorted with
+ * `cmp`; on equal elements, those of `list` come first. Afterwards `other` is
+ * empty but still has to be freed by the caller, and `list` becomes
+ * responsible for freeing the moved data.
+ *
+ * @param[in] list Pointer to the sorted linked list receiving the nodes.
+ * @param[in] other Pointer to the sorted linked list to empty into `list`.
+ * @param[in] cmp Comparison function both lists are sorted with.
+ */
+void merge_sorted(LinkedList *list, LinkedList *other,
+                  int (*cmp)(const void *, const void *))
+{
+    if (!list || !other || list == other || list_unshare(list) != 0
+        || list_unshare(other) != 0)
+        return;
+
+    retire_adopt(list, other);
+    drop_sorted_index(list);
+    drop_sorted_index(other);
+    list->head = merge(list->head, other->head, cmp);
+    list->size += other->size;
+    other->head = NULL;
+    other->size = 0;
+    hash_index_rebuild(list);
+    hash_index_rebuild(other);
+}
+
+typedef struct MergeSource
+{
+    Node *node;
+    size_t list;
+} MergeSource;
+
+// Min-heap order on the current node of each source, ties by list position
+static int source_before(const MergeSource *a, const MergeSource *b,
+                         int (*cmp)(const void *, const void *))
+{
+    int order = cmp(a->node->data, b->node->data);
+    return order < 0 || (order == 0 && a->list < b->list);
+}
+
+static void source_sift_down(MergeSource *heap, size_t size, size_t index,
+                             int (*cmp)(const void *, const void *))
+{
+    for (;;)
+    {
+        size_t smallest = index;
+        size_t left = 2 * index + 1;
+        size_t right = left + 1;
 
-    // Fusionner les deux listes
-    while (left && right)
+        if (left < size && source_before(&heap[left], &heap[smallest], cmp))
+            smallest = left;
+        if (right < size && source_before(&heap[right], &heap[smallest], cmp))
+            smallest = right;
+        if (smallest == index)
+            break;
+
+        MergeSource tmp = heap[smallest];
+        heap[smallest] = heap[index];
+        heap[index] = tmp;
+        index = smallest;
+    }
+}
+
+/**
+ * @brief Merge k sorted linked lists into a new sorted list.
+ *
+ * This function relinks the nodes of every input list into a new list using a
+ * min-heap over the heads of the inputs, which takes O(n log k) comparisons.
+ * The merge is stable: on equal elements, the list that comes first in
+ * `lists` wins. The input lists are left empty but still have to be freed by
+ * the caller.
+ *
+ * @param[in] lists Array of sorted linked lists to merge.
+ * @param[in] k Number of lists in the array.
+ * @param[in] cmp Comparison function every list is sorted with.
+ * @return A new linked list holding every node, using the free_data function
+ * of the first list, or NULL if memory allocation fails.
+ */
+LinkedList *kway_merge(LinkedList **lists, size_t k,
+                       int (*cmp)(const void *, const void *))
+{
+    for (size_t i = 0; i < k; i++)
     {
-        if (cmp(left->data, right->data) <= 0)
+        if (list_unshare(lists[i]) != 0)
+            return NULL;
+    }
+
+    LinkedList *result = init_linked_list(k ? lists[0]->free_data : NULL);
+    if (!result)
+        return NULL;
+
+    MergeSource *heap = malloc((k ? k : 1) * sizeof(MergeSource));
+    if (!heap)
+    {
+        free_linked_list(result);
+        return NULL;
+    }
+
+    size_t size = 0;
+    for (size_t i = 0; i < k; i++)
+    {
+        retire_adopt(result, lists[i]);
+        if (lists[i]->head)
         {
-            tail->next = left;
-            left = left->next;
+            heap[size].node = lists[i]->head;
+            heap[size].list = i;
+            size++;
         }
+        result->size += lists[i]->size;
+        drop_sorted_index(lists[i]);
+        lists[i]->head = NULL;
+        lists[i]->size = 0;
+        hash_index_rebuild(lists[i]);
+    }
+
+    for (size_t i = size / 2; i-- > 0;)
+        source_sift_down(heap, size, i, cmp);
+
+    Node **tail = &result->head;
+    while (size)
+    {
+        Node *node = heap[0].node;
+        *tail = node;
+        tail = &node->next;
+
+        if (node->next)
+            heap[0].node = node->next;
         else
+            heap[0] = heap[--size];
+        source_sift_down(heap, size, 0, cmp);
+    }
+
+    free(heap);
+    return result;
+}
+
+/**
+ * @brief Find an element in a sorted linked list.
+ *
+ * This function looks up an element in a list sorted with `cmp` without
+ * scanning the whole list. On first use it builds a sparse index holding
+ * every sqrt(n)-th node, so each lookup costs a binary search over the index
+ * plus a walk of at most about sqrt(n) nodes. The index is kept across
+ * lookups and dropped when the list is reordered or shrinks.
+ *
+ * @param[in] list Pointer to the sorted linked list.
+ * @param[in] key Pointer to the value to look for, passed as the second
+ * argument of `cmp`.
+ * @param[in] cmp Comparison function the list is sorted with.
+ * @return Pointer to the data of the first element equal to `key`, or NULL
+ * if there is none.
+ */
+void *find_sorted(LinkedList *list, const void *key,
+                  int (*cmp)(const void *, const void *))
+{
+    if (!list || !list->head)
+        return NULL;
+    if (!list->sorted_index)
+        build_sorted_index(list);
+
+    Node *current = sample_before(list, key, cmp, 0);
+    current = current ? current->next : list->head;
+    while (current)
+    {
+        int order = cmp(current->data, key);
+        if (order == 0)
+            return current->data;
+        if (order > 0)
+            break;
+        current = current->next;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Get the number of elements in the linked list.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @return The number of elements in the list, or 0 if list is NULL.
+ */
+size_t list_length(LinkedList *list)
+{
+    return list ? list->size : 0;
+}
+
+/**
+ * @brief Copy the data pointers of the linked list into an array.
+ *
+ * This function walks the list once and stores the data pointer of each
+ * element, in order, into `out`. The data itself is not copied and remains
+ * owned by the list.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @param[out] out Array receiving the data pointers. It must have room for
+ * list_length(list) entries.
+ * @return The number of pointers written to `out`.
+ */
+size_t list_to_array(LinkedList *list, void **out)
+{
+    if (!list || !out)
+        return 0;
+
+    size_t count = 0;
+    for (Node *current = list->head; current; current = current->next)
+        out[count++] = current->data;
+    return count;
+}
+
+/**
+ * @brief Create a linked list from an array of data pointers.
+ *
+ * This function allocates all the nodes of the new list in a single block
+ * and chains them in one linear pass, instead of calling append for each
+ * element. The list takes ownership of the data, which is freed with
+ * `free_data` like for any other list.
+ *
+ * @param[in] items Array of data pointers to store, in list order.
+ * @param[in] count Number of entries in `items`.
+ * @param[in] free_data Function pointer used to free the data stored in the
+ * list nodes.
+ * @return Pointer to the newly created LinkedList, or NULL if memory
+ * allocation fails.
+ */
+LinkedList *list_from_array(void **items, size_t count,
+                            void (*free_data)(void *))
+{
+    LinkedList *list = init_linked_list(free_data);
+    if (!list || count == 0)
+        return list;
+
+    Node *nodes = create_node_block(count);
+    if (!nodes)
+    {
+        free(list);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++)
+        nodes[i].data = items[i];
+    list->head = nodes;
+    list->size = count;
+    return list;
+}
+
+/**
+ * @brief Measure how scattered the nodes of the linked list are in memory.
+ *
+ * A link is counted as fragmented when the next node is not the one stored
+ * right after the current node, that is when following it is not a
+ * sequential memory access.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @return The fraction of fragmented links, between 0 for a list laid out
+ * in a single block in list order and 1, or 0 for lists shorter than two
+ * elements.
+ */
+double list_fragmentation(LinkedList *list)
+{
+    if (!list || list->size < 2)
+        return 0;
+
+    size_t scattered = 0;
+    for (Node *current = list->head; current->next; current = current->next)
+    {
+        if (current->next != current + 1)
+            scattered++;
+    }
+    return (double)scattered / (double)(list->size - 1);
+}
+
+/**
+ * @brief Relocate the nodes of the linked list into one contiguous block.
+ *
+ * This function copies the list into a single block of nodes laid out in
+ * list order and releases the old nodes, so that traversals become a
+ * sequential memory scan again after a long series of insertions and
+ * removals. The data pointers are moved as they are, so the data itself is
+ * neither copied nor freed. Lists already laid out this way are left alone.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @return 0 on success, or -1 if the new block could not be allocated, in
+ * which case the list is left unchanged.
+ */
+int list_compact(LinkedList *list)
+{
+    if (!list)
+        return -1;
+
+    // A chain still used by clones is copied into a single block, which is
+    // all compaction would do; the last user of a chain compacts it as usual
+    if (list->share)
+    {
+        int copied = atomic_load(&list->share->refs) > 1;
+        if (list_unshare(list) != 0)
+            return -1;
+        if (copied)
+            return 0;
+    }
+
+    list->churn = 0;
+    if (list_fragmentation(list) == 0)
+        return 0;
+
+    Node *nodes = create_node_block(list->size);
+    if (!nodes)
+        return -1;
+
+    Prefetcher prefetcher;
+    prefetcher_init(&prefetcher, list->head);
+
+    size_t index = 0;
+    Node *current = list->head;
+    while (current)
+    {
+        Node *next = current->next;
+        prefetcher_step(&prefetcher);
+        nodes[index++].data = current->data;
+        free_node(current);
+        current = next;
+    }
+
+    drop_sorted_index(list);
+    list->head = nodes;
+    hash_index_rebuild(list);
+    return 0;
+}
+
+/**
+ * @brief Compact the linked list automatically as it is modified.
+ *
+ * Once the number of insertions and removals since the last compaction
+ * reaches `churn_ratio` times the length of the list, the next modification
+ * calls list_compact. A ratio of 0 disables automatic compaction, which is
+ * the default.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @param[in] churn_ratio Share of the list to churn before compacting it.
+ */
+void list_set_auto_compact(LinkedList *list, double churn_ratio)
+{
+    if (!list)
+        return;
+    list->compact_ratio = churn_ratio > 0 ? churn_ratio : 0;
+    list->churn = 0;
+}
+
+/**
+ * @brief Estimate the memory used by the linked list.
+ *
+ * The nodes, the allocator overhead of the list and of its nodes, and the
+ * sparse index of sorted lists are accounted for. Payloads are measured with
+ * `payload_size`, without allocator overhead since the list does not
+ * allocate them. A chain shared with copy-on-write clones is counted in full
+ * for each of them. If the list is tracked by the memory usage registry, the
+ * registry is updated with the result.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @param[in] payload_size Function returning the size of an element, or NULL
+ * to leave payloads out.
+ * @return The estimated memory usage, all zero if `list` is NULL.
+ */
+MemoryUsage list_memory_usage(LinkedList *list,
+                              size_t (*payload_size)(const void *data))
+{
+    MemoryUsage usage = {0};
+    if (!list)
+        return usage;
+
+    size_t header_bytes = allocation_footprint(sizeof(LinkedList));
+    if (list->sorted_index)
+        header_bytes += allocation_footprint(
+            sizeof(struct SortedIndex)
+            + list->sorted_index->count * sizeof(Node *));
+    if (list->hash_index)
+        header_bytes += allocation_footprint(sizeof(HashIndex))
+            + allocation_footprint(list->hash_index->capacity
+                                   * sizeof(HashSlot));
+
+    usage = chain_memory_usage(list->head, header_bytes, payload_size);
+    memory_registry_update(list->memory_entry, &usage);
+    return usage;
+}
+
+/**
+ * @brief Track the memory used by the linked list in the process registry.
+ *
+ * The list is measured right away, then again on every call to
+ * list_memory_usage, and memory_registry_total and memory_registry_export
+ * report the latest measurement until the list is freed. Tracking a list
+ * again renames it.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @param[in] name Name under which the list is exported.
+ * @param[in] payload_size Function returning the size of an element, or NULL
+ * to leave payloads out.
+ * @return 0 on success, or -1 if memory allocation fails.
+ */
+int list_track_memory(LinkedList *list, const char *name,
+                      size_t (*payload_size)(const void *data))
+{
+    if (!list)
+        return -1;
+
+    MemoryEntry *entry = memory_registry_add(name);
+    if (!entry)
+        return -1;
+    memory_registry_remove(list->memory_entry);
+    list->memory_entry = entry;
+    list_memory_usage(list, payload_size);
+    return 0;
+}
+
+/**
+ * @brief Create a copy-on-write clone of the linked list in O(1).
+ *
+ * The clone shares the node chain of `list` instead of copying it. Both
+ * lists can be read and traversed as usual, from different threads if
+ * needed; the first function that modifies the nodes of either one (append,
+ * insert_at, remove_at, sort, and so on) gives that list a private copy of
+ * the chain first. The chain is freed along with the last list using it.
+ *
+ * The clone reads the data without owning it, so its free_data function is
+ * NULL. Elements that `list` releases while clones may still read them,
+ * because they are removed or because `list` is freed, are only freed once
+ * those clones have been freed, so `list` can keep changing and be freed in
+ * any order with respect to its clones.
+ *
+ * @param[in] list Pointer to the linked list to clone.
+ * @return Pointer to the clone, or NULL if memory allocation fails.
+ */
+LinkedList *list_clone_cow(LinkedList *list)
+{
+    if (!list)
+        return NULL;
+
+    LinkedList *clone = init_linked_list(NULL);
+    if (!clone)
+        return NULL;
+
+    if (!list->share)
+    {
+        list->share = malloc(sizeof(struct ChainShare));
+        if (!list->share)
         {
-            tail->next = right;
-            right = right->next;
+            free(clone);
+            return NULL;
         }
-        tail = tail->next;
+        atomic_init(&list->share->refs, 1);
     }
+    if (retire_clone(clone, list) != 0)
+    {
+        free(clone);
+        return NULL;
+    }
+    atomic_fetch_add(&list->share->refs, 1);
+    clone->head = list->head;
+    clone->size = list->size;
+    clone->share = list->share;
+    return clone;
+}
 
-    // Ajouter les éléments restants
-    tail->next = left ? left : right;
+// Release the data of the list, and free its nodes unless clones still use
+// them
+static void release_chain(LinkedList *list)
+{
+    struct ChainShare *share = list->share;
+    if (!share)
+    {
+        retire_chain(list, list->head);
+        return;
+    }
 
-    return dummy.next;
+    if (list->free_data)
+    {
+        for (Node *current = list->head; current; current = current->next)
+            retire_data(list, current->data);
+    }
+    if (atomic_fetch_sub(&share->refs, 1) == 1)
+    {
+        free_chain(list->head, NULL);
+        free(share);
+    }
 }
 
 /**
@@ -375,7 +1437,8 @@ static Node *merge(Node *left, Node *right,
  *
  * This function iterates through the linked list, freeing each node and its
  * data. If a free_data function is provided, it is used to free the data in
- * each node. Be careful: all the data in the list will be freed.
+ * each node. Be careful: all the data in the list will be freed. Data that
+ * copy-on-write clones may still read is freed once they are freed.
  *
  * @param[in] list Pointer to the linked list to free.
  * @return void
@@ -385,18 +1448,10 @@ void free_linked_list(LinkedList *list)
     if (!list)
         return;
 
-    Node *current = list->head;
-    while (current != NULL)
-    {
-        Node *next_node = current->next;
-
-        if (list->free_data)
-        {
-            list->free_data(current->data);
-        }
-
-        free(current);
-        current = next_node;
-    }
+    release_chain(list);
+    retire_detach(list);
+    free(list->sorted_index);
+    list_detach_index(list);
+    memory_registry_remove(list->memory_entry);
     free(list);
 }
@@ -0,0 +1,69 @@
+#ifndef LINKED_LIST_H
+#define LINKED_LIST_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#include "node.h"
+
+// Sparse index over a sorted list: every stride-th node, used by find_sorted
+struct SortedIndex
+{
+    size_t count;
+    size_t stride;
+    size_t additions;
+    Node *samples[];
+};
+
+// Open-addressing hash index over the nodes of a list, with linear probing.
+// Empty slots have a NULL node; a NULL slots array marks a stale index that
+// is rebuilt on the next lookup.
+typedef struct HashSlot
+{
+    size_t hash;
+    Node *node;
+} HashSlot;
+
+typedef struct HashIndex
+{
+    size_t (*hash)(const void *data);
+    int (*eq)(const void *a, const void *b);
+    HashSlot *slots;
+    size_t capacity;
+    size_t count;
+} HashIndex;
+
+// Reference count of a node chain shared by copy-on-write clones
+struct ChainShare
+{
+    atomic_size_t refs;
+};
+
+struct LinkedList
+{
+    struct Node *head;
+    size_t size;
+    void (*free_data)(void *data);
+    struct SortedIndex *sorted_index;
+    size_t churn;         // insertions and removals since the last compaction
+    double compact_ratio; // churn/size ratio that triggers list_compact, or 0
+    struct MemoryEntry *memory_entry; // NULL unless tracked by the registry
+    struct ChainShare *share; // NULL unless the chain is shared with clones
+    // NULL unless the list, or one it took nodes from, was cloned
+    struct CloneLineage *lineage;
+    struct Generation *generation; // NULL unless the list is a clone
+    HashIndex *hash_index;    // NULL unless list_attach_index was called
+};
+
+Node *take_nodes(LinkedList *list);
+int list_unshare(LinkedList *list);
+void append_chain(LinkedList *list, Node *head, size_t count);
+LinkedList **init_bucket_lists(size_t count, void (*free_data)(void *));
+
+void hash_index_rebuild(LinkedList *list);
+void hash_index_insert(LinkedList *list, Node *node);
+void hash_index_remove(LinkedList *list, Node *node);
+void hash_index_move(LinkedList *list, Node *from, Node *to);
+Node *hash_index_lookup(LinkedList *list, const void *key);
+
+#endif
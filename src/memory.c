@@ -0,0 +1,197 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory.h"
+
+// Allocations at least this large are served by mmap rather than the heap
+#define MMAP_THRESHOLD (128 * 1024)
+#define PAGE_SIZE 4096
+
+struct MemoryEntry
+{
+    char *name;
+    MemoryUsage usage;
+    MemoryEntry *previous;
+    MemoryEntry *next;
+};
+
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static MemoryEntry *registry = NULL;
+
+/**
+ * @brief Estimate the memory malloc really uses for a request.
+ *
+ * This follows the usual layout of dlmalloc-style allocators such as glibc:
+ * a size word in front of each chunk, 16-byte granularity with a 32-byte
+ * minimum, and page-rounded mappings for large requests.
+ *
+ * @param request The number of bytes requested.
+ * @return size_t The estimated number of bytes consumed.
+ */
+size_t allocation_footprint(size_t request)
+{
+    size_t header = sizeof(size_t);
+    if (request + header >= MMAP_THRESHOLD)
+        return (request + 2 * header + PAGE_SIZE - 1) & ~(size_t)(PAGE_SIZE - 1);
+
+    size_t chunk = (request + header + 2 * header - 1) & ~(2 * header - 1);
+    return chunk < 4 * header ? 4 * header : chunk;
+}
+
+static void update_ratio(MemoryUsage *usage)
+{
+    size_t container = usage->node_bytes + usage->overhead_bytes;
+    size_t total = container + usage->payload_bytes;
+    usage->overhead_ratio = total ? (double)container / (double)total : 0;
+}
+
+/**
+ * @brief Measure a node chain and the container holding it.
+ *
+ * @param head First node of the chain.
+ * @param header_bytes Estimated footprint of the container itself and of its
+ * auxiliary allocations.
+ * @param payload_size Function returning the size of a payload, or NULL to
+ * leave payloads out.
+ * @return MemoryUsage The estimated footprint.
+ */
+MemoryUsage chain_memory_usage(Node *head, size_t header_bytes,
+                               size_t (*payload_size)(const void *data))
+{
+    MemoryUsage usage = {0};
+    size_t footprint = header_bytes;
+
+    Prefetcher prefetcher;
+    prefetcher_init(&prefetcher, head);
+
+    for (Node *current = head; current; current = current->next)
+    {
+        prefetcher_step(&prefetcher);
+        usage.elements++;
+        footprint += node_footprint(current);
+        if (payload_size && current->data)
+            usage.payload_bytes += payload_size(current->data);
+    }
+
+    usage.node_bytes = usage.elements * sizeof(Node);
+    usage.overhead_bytes =
+        footprint > usage.node_bytes ? footprint - usage.node_bytes : 0;
+    update_ratio(&usage);
+    return usage;
+}
+
+/**
+ * @brief Add a container to the memory usage registry.
+ *
+ * @param name Name reported for the container. It is copied.
+ * @return MemoryEntry* The new entry, or NULL if memory allocation fails.
+ */
+MemoryEntry *memory_registry_add(const char *name)
+{
+    MemoryEntry *entry = calloc(1, sizeof(MemoryEntry));
+    if (!entry)
+        return NULL;
+    entry->name = strdup(name ? name : "");
+    if (!entry->name)
+    {
+        free(entry);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&registry_lock);
+    entry->next = registry;
+    if (registry)
+        registry->previous = entry;
+    registry = entry;
+    pthread_mutex_unlock(&registry_lock);
+    return entry;
+}
+
+/**
+ * @brief Replace the usage recorded for a registered container.
+ *
+ * @param entry The registry entry of the container, or NULL.
+ * @param usage The latest measurement.
+ */
+void memory_registry_update(MemoryEntry *entry, const MemoryUsage *usage)
+{
+    if (!entry)
+        return;
+    pthread_mutex_lock(&registry_lock);
+    entry->usage = *usage;
+    pthread_mutex_unlock(&registry_lock);
+}
+
+/**
+ * @brief Remove a container from the memory usage registry.
+ *
+ * @param entry The registry entry of the container, or NULL.
+ */
+void memory_registry_remove(MemoryEntry *entry)
+{
+    if (!entry)
+        return;
+
+    pthread_mutex_lock(&registry_lock);
+    if (entry->previous)
+        entry->previous->next = entry->next;
+    else
+        registry = entry->next;
+    if (entry->next)
+        entry->next->previous = entry->previous;
+    pthread_mutex_unlock(&registry_lock);
+
+    free(entry->name);
+    free(entry);
+}
+
+/**
+ * @brief Sum the latest usage of every tracked container.
+ *
+ * Each container contributes the measurement taken by its last call to
+ * list_memory_usage or stack_memory_usage, or by the call that started
+ * tracking it, so this can be called from any thread.
+ *
+ * @return MemoryUsage The aggregated usage.
+ */
+MemoryUsage memory_registry_total(void)
+{
+    MemoryUsage total = {0};
+
+    pthread_mutex_lock(&registry_lock);
+    for (MemoryEntry *entry = registry; entry; entry = entry->next)
+    {
+        total.elements += entry->usage.elements;
+        total.node_bytes += entry->usage.node_bytes;
+        total.overhead_bytes += entry->usage.overhead_bytes;
+        total.payload_bytes += entry->usage.payload_bytes;
+    }
+    pthread_mutex_unlock(&registry_lock);
+
+    update_ratio(&total);
+    return total;
+}
+
+/**
+ * @brief Report the latest usage of every tracked container.
+ *
+ * The callback runs with the registry locked, so it must not start or stop
+ * tracking containers, nor free tracked ones.
+ *
+ * @param emit Function called with the name and usage of each container.
+ * @param context Pointer passed through to `emit`.
+ */
+void memory_registry_export(void (*emit)(const char *name,
+                                         const MemoryUsage *usage,
+                                         void *context),
+                            void *context)
+{
+    if (!emit)
+        return;
+
+    pthread_mutex_lock(&registry_lock);
+    for (MemoryEntry *entry = registry; entry; entry = entry->next)
+        emit(entry->name, &entry->usage, context);
+    pthread_mutex_unlock(&registry_lock);
+}
@@ -0,0 +1,18 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stddef.h>
+
+#include "node.h"
+
+typedef struct MemoryEntry MemoryEntry;
+
+size_t allocation_footprint(size_t request);
+MemoryUsage chain_memory_usage(Node *head, size_t header_bytes,
+                               size_t (*payload_size)(const void *data));
+
+MemoryEntry *memory_registry_add(const char *name);
+void memory_registry_update(MemoryEntry *entry, const MemoryUsage *usage);
+void memory_registry_remove(MemoryEntry *entry);
+
+#endif
@@ -0,0 +1,195 @@
+/*
+ * Natural merge sort over singly linked nodes, shared by the containers that
+ * sort chains of their own node type. Define before including:
+ *
+ *   SORT_NODE        the node type, linked through a `next` member
+ *   SORT_KEY(node)   the pointer handed to the comparison function
+ *   SORT_NAME(name)  the name given to each generated static function
+ *
+ * This generates SORT_NAME(merge) and SORT_NAME(natural_merge_sort), and
+ * undefines the three parameters so that it can be included again.
+ */
+
+#ifndef MERGE_SORT_H
+#define MERGE_SORT_H
+
+// Minimum length of a run: shorter natural runs are extended by insertion
+#define MIN_RUN 16
+// Upper bound on pending runs; the stack invariants keep run lengths growing
+// at least like Fibonacci numbers, so this is never reached with a size_t size
+#define MAX_RUNS 128
+
+#endif
+
+typedef struct SORT_NAME(Run)
+{
+    SORT_NODE *head;
+    size_t length;
+} SORT_NAME(Run);
+
+// Fonction pour fusionner deux sous-listes triées
+static SORT_NODE *SORT_NAME(merge)(SORT_NODE *left, SORT_NODE *right,
+                                   int (*cmp)(const void *, const void *))
+{
+    // Liste temporaire pour le résultat
+    SORT_NODE dummy;
+    SORT_NODE *tail = &dummy;
+    dummy.next = NULL;
+
+    // Fusionner les deux listes, en préchargeant le successeur du noeud pris
+    while (left && right)
+    {
+        if (cmp(SORT_KEY(left), SORT_KEY(right)) <= 0)
+        {
+            tail->next = left;
+            left = left->next;
+            if (left)
+                __builtin_prefetch(left->next);
+        }
+        else
+        {
+            tail->next = right;
+            right = right->next;
+            if (right)
+                __builtin_prefetch(right->next);
+        }
+        tail = tail->next;
+    }
+
+    // Ajouter les éléments restants
+    tail->next = left ? left : right;
+
+    return dummy.next;
+}
+
+// Detach the run starting at *source and advance *source past it.
+// Strictly descending runs are reversed so that every run is ascending, and
+// short runs are extended to MIN_RUN nodes by stable insertion.
+static SORT_NODE *SORT_NAME(take_run)(SORT_NODE **source, size_t *length,
+                                      int (*cmp)(const void *, const void *))
+{
+    SORT_NODE *head = *source;
+    SORT_NODE *tail = head;
+    SORT_NODE *next = head->next;
+    size_t count = 1;
+
+    if (next && cmp(SORT_KEY(head), SORT_KEY(next)) > 0)
+    {
+        // Strictly descending: reverse the nodes while walking
+        head->next = NULL;
+        do
+        {
+            SORT_NODE *after = next->next;
+            next->next = head;
+            head = next;
+            next = after;
+            count++;
+        } while (next && cmp(SORT_KEY(head), SORT_KEY(next)) > 0);
+    }
+    else if (next)
+    {
+        // Ascending: head <= next is already known
+        tail = next;
+        next = next->next;
+        count++;
+        while (next && cmp(SORT_KEY(tail), SORT_KEY(next)) <= 0)
+        {
+            tail = next;
+            next = next->next;
+            count++;
+        }
+        tail->next = NULL;
+    }
+
+    while (count < MIN_RUN && next)
+    {
+        SORT_NODE *node = next;
+        next = next->next;
+
+        if (cmp(SORT_KEY(tail), SORT_KEY(node)) <= 0)
+        {
+            tail->next = node;
+            tail = node;
+            node->next = NULL;
+        }
+        else
+        {
+            SORT_NODE **link = &head;
+            while (cmp(SORT_KEY(*link), SORT_KEY(node)) <= 0)
+                link = &(*link)->next;
+            node->next = *link;
+            *link = node;
+        }
+        count++;
+    }
+
+    *source = next;
+    *length = count;
+    return head;
+}
+
+// Merge runs[index] with runs[index + 1] and close the gap on the stack
+static void SORT_NAME(merge_at)(SORT_NAME(Run) *runs, size_t *count,
+                                size_t index,
+                                int (*cmp)(const void *, const void *))
+{
+    runs[index].head =
+        SORT_NAME(merge)(runs[index].head, runs[index + 1].head, cmp);
+    runs[index].length += runs[index + 1].length;
+    if (index + 2 < *count)
+        runs[index + 1] = runs[index + 2];
+    (*count)--;
+}
+
+// Merge pending runs until the stack invariants hold again:
+// len[i - 2] > len[i - 1] + len[i] and len[i - 1] > len[i]
+static void SORT_NAME(merge_collapse)(SORT_NAME(Run) *runs, size_t *count,
+                                      int (*cmp)(const void *, const void *))
+{
+    while (*count > 1)
+    {
+        size_t n = *count - 2;
+        if ((n > 0 && runs[n - 1].length <= runs[n].length + runs[n + 1].length)
+            || (n > 1
+                && runs[n - 2].length <= runs[n - 1].length + runs[n].length))
+        {
+            if (runs[n - 1].length < runs[n + 1].length)
+                n--;
+        }
+        else if (runs[n].length > runs[n + 1].length)
+        {
+            break;
+        }
+        SORT_NAME(merge_at)(runs, count, n, cmp);
+    }
+}
+
+// Natural merge sort: split the list into runs in a single pass and merge
+// them with a balanced stack, like Timsort does for arrays
+static SORT_NODE *SORT_NAME(natural_merge_sort)(
+    SORT_NODE *head, int (*cmp)(const void *, const void *))
+{
+    SORT_NAME(Run) runs[MAX_RUNS];
+    size_t count = 0;
+
+    while (head)
+    {
+        runs[count].head = SORT_NAME(take_run)(&head, &runs[count].length, cmp);
+        count++;
+        SORT_NAME(merge_collapse)(runs, &count, cmp);
+    }
+
+    while (count > 1)
+    {
+        size_t n = count - 2;
+        if (n > 0 && runs[n - 1].length < runs[n + 1].length)
+            n--;
+        SORT_NAME(merge_at)(runs, &count, n, cmp);
+    }
+
+    return count ? runs[0].head : NULL;
+}
+
+#undef SORT_NODE
+#undef SORT_KEY
+#undef SORT_NAME
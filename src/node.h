@@ -1,14 +1,54 @@
-#ifndef LINKED_LIST_H
-#define LINKED_LIST_H
+#ifndef NODE_H
+#define NODE_H
 
 #include <stddef.h>
 
 #include "../include/utils.h"
 
+typedef struct NodeBlock NodeBlock;
+
 typedef struct Node
 {
     void *data;
     struct Node *next;
+    struct NodeBlock *block; // NULL when the node was allocated on its own
 } Node;
 
-#endif
\ No newline at end of file
+Node *create_node(void *data, Node *next);
+Node *create_node_block(size_t count);
+void free_node(Node *node);
+void free_chain(Node *head, void (*free_data)(void *data));
+size_t node_footprint(const Node *node);
+size_t prefetch_settings(int *payloads);
+
+// Software prefetching for chain walks. A second cursor runs `distance`
+// nodes ahead of the walk and prefetches every node it reaches, and the
+// payload of the node behind it when payload prefetching is enabled, so that
+// the memory latency overlaps with the work done on the current node.
+typedef struct Prefetcher
+{
+    Node *ahead;
+    int payloads;
+} Prefetcher;
+
+static inline void prefetcher_step(Prefetcher *prefetcher)
+{
+    Node *behind = prefetcher->ahead;
+    if (!behind)
+        return;
+    prefetcher->ahead = behind->next;
+    if (prefetcher->ahead)
+        __builtin_prefetch(prefetcher->ahead);
+    if (prefetcher->payloads)
+        __builtin_prefetch(behind->data);
+}
+
+static inline void prefetcher_init(Prefetcher *prefetcher, Node *head)
+{
+    size_t distance = prefetch_settings(&prefetcher->payloads);
+    prefetcher->ahead = distance ? head : NULL;
+    for (size_t i = 0; i < distance && prefetcher->ahead; i++)
+        prefetcher_step(prefetcher);
+}
+
+#endif
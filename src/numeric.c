@@ -0,0 +1,622 @@
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "linked_list.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NUMERIC_X86 1
+#include <immintrin.h>
+#endif
+
+struct NumericArray
+{
+    double *values;
+    size_t size;
+    size_t capacity;
+};
+
+typedef struct NumericKernels
+{
+    double (*sum)(const double *values, size_t count);
+    double (*min)(const double *values, size_t count);
+    double (*max)(const double *values, size_t count);
+    size_t (*count_if)(const double *values, size_t count, NumericOp op,
+                       double threshold);
+    size_t (*filter)(const double *values, size_t count, NumericOp op,
+                     double threshold, double *out);
+    void (*affine)(double *values, size_t count, double scale,
+                   double offset);
+} NumericKernels;
+
+// Scalar kernels, also used for the tails of the vector kernels
+
+static int compare(double value, NumericOp op, double threshold)
+{
+    switch (op)
+    {
+    case NUMERIC_LT:
+        return value < threshold;
+    case NUMERIC_LE:
+        return value <= threshold;
+    case NUMERIC_GT:
+        return value > threshold;
+    case NUMERIC_GE:
+        return value >= threshold;
+    case NUMERIC_EQ:
+        return value == threshold;
+    default:
+        return value != threshold;
+    }
+}
+
+static double scalar_sum(const double *values, size_t count)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < count; i++)
+        sum += values[i];
+    return sum;
+}
+
+static double scalar_min(const double *values, size_t count)
+{
+    double min = INFINITY;
+    for (size_t i = 0; i < count; i++)
+        min = values[i] < min ? values[i] : min;
+    return min;
+}
+
+static double scalar_max(const double *values, size_t count)
+{
+    double max = -INFINITY;
+    for (size_t i = 0; i < count; i++)
+        max = values[i] > max ? values[i] : max;
+    return max;
+}
+
+static size_t scalar_count_if(const double *values, size_t count,
+                              NumericOp op, double threshold)
+{
+    size_t matches = 0;
+    for (size_t i = 0; i < count; i++)
+        matches += compare(values[i], op, threshold);
+    return matches;
+}
+
+static size_t scalar_filter(const double *values, size_t count, NumericOp op,
+                            double threshold, double *out)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (compare(values[i], op, threshold))
+            out[kept++] = values[i];
+    }
+    return kept;
+}
+
+static void scalar_affine(double *values, size_t count, double scale,
+                          double offset)
+{
+    for (size_t i = 0; i < count; i++)
+        values[i] = values[i] * scale + offset;
+}
+
+static const NumericKernels scalar_kernels = {
+    scalar_sum,      scalar_min,    scalar_max,
+    scalar_count_if, scalar_filter, scalar_affine,
+};
+
+#ifdef NUMERIC_X86
+
+// SSE2 kernels, two doubles per vector
+
+static __m128d sse2_compare(__m128d values, NumericOp op, __m128d threshold)
+{
+    switch (op)
+    {
+    case NUMERIC_LT:
+        return _mm_cmplt_pd(values, threshold);
+    case NUMERIC_LE:
+        return _mm_cmple_pd(values, threshold);
+    case NUMERIC_GT:
+        return _mm_cmpgt_pd(values, threshold);
+    case NUMERIC_GE:
+        return _mm_cmpge_pd(values, threshold);
+    case NUMERIC_EQ:
+        return _mm_cmpeq_pd(values, threshold);
+    default:
+        return _mm_cmpneq_pd(values, threshold);
+    }
+}
+
+static double sse2_sum(const double *values, size_t count)
+{
+    __m128d first = _mm_setzero_pd();
+    __m128d second = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        first = _mm_add_pd(first, _mm_loadu_pd(values + i));
+        second = _mm_add_pd(second, _mm_loadu_pd(values + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(first, second));
+    return lanes[0] + lanes[1] + scalar_sum(values + i, count - i);
+}
+
+static double sse2_min(const double *values, size_t count)
+{
+    __m128d min = _mm_set1_pd(INFINITY);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+        min = _mm_min_pd(min, _mm_loadu_pd(values + i));
+    double lanes[2];
+    _mm_storeu_pd(lanes, min);
+    double tail = scalar_min(values + i, count - i);
+    double result = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+    return tail < result ? tail : result;
+}
+
+static double sse2_max(const double *values, size_t count)
+{
+    __m128d max = _mm_set1_pd(-INFINITY);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+        max = _mm_max_pd(max, _mm_loadu_pd(values + i));
+    double lanes[2];
+    _mm_storeu_pd(lanes, max);
+    double tail = scalar_max(values + i, count - i);
+    double result = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+    return tail > result ? tail : result;
+}
+
+static size_t sse2_count_if(const double *values, size_t count, NumericOp op,
+                            double threshold)
+{
+    __m128d limit = _mm_set1_pd(threshold);
+    size_t matches = 0;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        int mask =
+            _mm_movemask_pd(sse2_compare(_mm_loadu_pd(values + i), op, limit));
+        matches += (size_t)__builtin_popcount(mask);
+    }
+    return matches + scalar_count_if(values + i, count - i, op, threshold);
+}
+
+static size_t sse2_filter(const double *values, size_t count, NumericOp op,
+                          double threshold, double *out)
+{
+    __m128d limit = _mm_set1_pd(threshold);
+    size_t kept = 0;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        int mask =
+            _mm_movemask_pd(sse2_compare(_mm_loadu_pd(values + i), op, limit));
+        if (mask & 1)
+            out[kept++] = values[i];
+        if (mask & 2)
+            out[kept++] = values[i + 1];
+    }
+    return kept
+        + scalar_filter(values + i, count - i, op, threshold, out + kept);
+}
+
+static void sse2_affine(double *values, size_t count, double scale,
+                        double offset)
+{
+    __m128d factor = _mm_set1_pd(scale);
+    __m128d shift = _mm_set1_pd(offset);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d value = _mm_loadu_pd(values + i);
+        _mm_storeu_pd(values + i, _mm_add_pd(_mm_mul_pd(value, factor), shift));
+    }
+    scalar_affine(values + i, count - i, scale, offset);
+}
+
+static const NumericKernels sse2_kernels = {
+    sse2_sum,      sse2_min,    sse2_max,
+    sse2_count_if, sse2_filter, sse2_affine,
+};
+
+// AVX2 kernels, four doubles per vector, compiled for AVX2 whatever the
+// flags of the rest of the library and only called when the CPU has it
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static __m256d avx2_compare(__m256d values, NumericOp op,
+                                 __m256d threshold)
+{
+    switch (op)
+    {
+    case NUMERIC_LT:
+        return _mm256_cmp_pd(values, threshold, _CMP_LT_OQ);
+    case NUMERIC_LE:
+        return _mm256_cmp_pd(values, threshold, _CMP_LE_OQ);
+    case NUMERIC_GT:
+        return _mm256_cmp_pd(values, threshold, _CMP_GT_OQ);
+    case NUMERIC_GE:
+        return _mm256_cmp_pd(values, threshold, _CMP_GE_OQ);
+    case NUMERIC_EQ:
+        return _mm256_cmp_pd(values, threshold, _CMP_EQ_OQ);
+    default:
+        return _mm256_cmp_pd(values, threshold, _CMP_NEQ_UQ);
+    }
+}
+
+AVX2 static double avx2_sum(const double *values, size_t count)
+{
+    __m256d first = _mm256_setzero_pd();
+    __m256d second = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        first = _mm256_add_pd(first, _mm256_loadu_pd(values + i));
+        second = _mm256_add_pd(second, _mm256_loadu_pd(values + i + 4));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(first, second));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3])
+        + scalar_sum(values + i, count - i);
+}
+
+AVX2 static double avx2_min(const double *values, size_t count)
+{
+    __m256d min = _mm256_set1_pd(INFINITY);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        min = _mm256_min_pd(min, _mm256_loadu_pd(values + i));
+    double lanes[4];
+    _mm256_storeu_pd(lanes, min);
+    double tail = scalar_min(values + i, count - i);
+    double result = scalar_min(lanes, 4);
+    return tail < result ? tail : result;
+}
+
+AVX2 static double avx2_max(const double *values, size_t count)
+{
+    __m256d max = _mm256_set1_pd(-INFINITY);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        max = _mm256_max_pd(max, _mm256_loadu_pd(values + i));
+    double lanes[4];
+    _mm256_storeu_pd(lanes, max);
+    double tail = scalar_max(values + i, count - i);
+    double result = scalar_max(lanes, 4);
+    return tail > result ? tail : result;
+}
+
+AVX2 static size_t avx2_count_if(const double *values, size_t count,
+                                 NumericOp op, double threshold)
+{
+    __m256d limit = _mm256_set1_pd(threshold);
+    size_t matches = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        int mask = _mm256_movemask_pd(
+            avx2_compare(_mm256_loadu_pd(values + i), op, limit));
+        matches += (size_t)__builtin_popcount(mask);
+    }
+    return matches + scalar_count_if(values + i, count - i, op, threshold);
+}
+
+AVX2 static size_t avx2_filter(const double *values, size_t count,
+                               NumericOp op, double threshold, double *out)
+{
+    __m256d limit = _mm256_set1_pd(threshold);
+    size_t kept = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        int mask = _mm256_movemask_pd(
+            avx2_compare(_mm256_loadu_pd(values + i), op, limit));
+        if (mask == 0xF)
+        {
+            _mm256_storeu_pd(out + kept, _mm256_loadu_pd(values + i));
+            kept += 4;
+            continue;
+        }
+        while (mask)
+        {
+            int lane = __builtin_ctz(mask);
+            out[kept++] = values[i + lane];
+            mask &= mask - 1;
+        }
+    }
+    return kept
+        + scalar_filter(values + i, count - i, op, threshold, out + kept);
+}
+
+AVX2 static void avx2_affine(double *values, size_t count, double scale,
+                             double offset)
+{
+    __m256d factor = _mm256_set1_pd(scale);
+    __m256d shift = _mm256_set1_pd(offset);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d value = _mm256_loadu_pd(values + i);
+        _mm256_storeu_pd(values + i,
+                         _mm256_add_pd(_mm256_mul_pd(value, factor), shift));
+    }
+    scalar_affine(values + i, count - i, scale, offset);
+}
+
+static const NumericKernels avx2_kernels = {
+    avx2_sum,      avx2_min,    avx2_max,
+    avx2_count_if, avx2_filter, avx2_affine,
+};
+
+#endif /* NUMERIC_X86 */
+
+static const NumericKernels *kernels = &scalar_kernels;
+static NumericIsa selected_isa = NUMERIC_SCALAR;
+static pthread_once_t detect_once = PTHREAD_ONCE_INIT;
+
+// Best instruction set the CPU running the library supports
+static NumericIsa best_isa(void)
+{
+#ifdef NUMERIC_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return NUMERIC_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return NUMERIC_SSE2;
+#endif
+    return NUMERIC_SCALAR;
+}
+
+static void use_isa(NumericIsa isa)
+{
+    NumericIsa best = best_isa();
+    if (isa > best)
+        isa = best;
+
+    selected_isa = isa;
+#ifdef NUMERIC_X86
+    if (isa == NUMERIC_AVX2)
+        kernels = &avx2_kernels;
+    else if (isa == NUMERIC_SSE2)
+        kernels = &sse2_kernels;
+    else
+#endif
+        kernels = &scalar_kernels;
+}
+
+static void detect_isa(void)
+{
+    use_isa(NUMERIC_AVX2);
+}
+
+static const NumericKernels *numeric_kernels(void)
+{
+    pthread_once(&detect_once, detect_isa);
+    return kernels;
+}
+
+/**
+ * @brief Get the instruction set used by the numeric kernels.
+ *
+ * On first use, the best instruction set supported by the CPU is detected:
+ * AVX2, then SSE2, then plain scalar code.
+ *
+ * @return The instruction set currently in use.
+ */
+NumericIsa numeric_isa(void)
+{
+    numeric_kernels();
+    return selected_isa;
+}
+
+/**
+ * @brief Choose the instruction set used by the numeric kernels.
+ *
+ * Requests above what the CPU supports fall back to the best supported
+ * instruction set. This is meant for testing and benchmarking, and must not
+ * be called while other threads use numeric arrays.
+ *
+ * @param isa The instruction set to use.
+ * @return The instruction set actually selected.
+ */
+NumericIsa numeric_set_isa(NumericIsa isa)
+{
+    numeric_kernels();
+    use_isa(isa);
+    return selected_isa;
+}
+
+/**
+ * @brief Initialize a new, empty numeric array.
+ *
+ * A numeric array stores doubles contiguously, so that aggregations and
+ * filters run as vectorized scans instead of walking nodes and calling a
+ * function per element.
+ *
+ * @param capacity Number of values to reserve room for, may be 0.
+ * @return NumericArray* A pointer to the newly created array, or NULL if
+ * memory allocation fails.
+ */
+NumericArray *init_numeric_array(size_t capacity)
+{
+    NumericArray *array = malloc(sizeof(NumericArray));
+    if (!array)
+        return NULL;
+    array->values = malloc((capacity ? capacity : 1) * sizeof(double));
+    if (!array->values)
+    {
+        free(array);
+        return NULL;
+    }
+    array->size = 0;
+    array->capacity = capacity ? capacity : 1;
+    return array;
+}
+
+/**
+ * @brief Build a numeric array from a linked list of numbers.
+ *
+ * @param list The linked list to convert. Its data must be `int *` or
+ * `double *` payloads, as given by `type`. The list is not modified.
+ * @param type Type of the payloads of the list.
+ * @return NumericArray* A new array holding the values in list order, or
+ * NULL if memory allocation fails.
+ */
+NumericArray *numeric_from_list(LinkedList *list, NumericType type)
+{
+    NumericArray *array = init_numeric_array(list->size);
+    if (!array)
+        return NULL;
+
+    for (Node *current = list->head; current; current = current->next)
+    {
+        array->values[array->size++] = type == NUMERIC_INT
+            ? (double)*(int *)current->data
+            : *(double *)current->data;
+    }
+    return array;
+}
+
+/**
+ * @brief Append a value at the end of the numeric array.
+ *
+ * @param array The numeric array.
+ * @param value The value to append.
+ */
+void num_push(NumericArray *array, double value)
+{
+    if (array->size == array->capacity)
+    {
+        double *values =
+            realloc(array->values, 2 * array->capacity * sizeof(double));
+        if (!values)
+            return;
+        array->values = values;
+        array->capacity *= 2;
+    }
+    array->values[array->size++] = value;
+}
+
+/**
+ * @brief Get the number of values in the numeric array.
+ *
+ * @param array The numeric array.
+ * @return size_t The number of values.
+ */
+size_t num_length(NumericArray *array)
+{
+    return array ? array->size : 0;
+}
+
+/**
+ * @brief Get the contiguous storage of the numeric array.
+ *
+ * @param array The numeric array.
+ * @return double* Pointer to the num_length(array) values, valid until the
+ * next num_push.
+ */
+double *num_data(NumericArray *array)
+{
+    return array->values;
+}
+
+/**
+ * @brief Sum the values of the numeric array.
+ *
+ * The vector kernels add the values in several interleaved partial sums, so
+ * rounding may differ slightly from a sequential scalar sum.
+ *
+ * @param array The numeric array.
+ * @return double The sum of the values, 0 for an empty array.
+ */
+double num_sum(NumericArray *array)
+{
+    return numeric_kernels()->sum(array->values, array->size);
+}
+
+/**
+ * @brief Get the smallest value of the numeric array.
+ *
+ * @param array The numeric array.
+ * @return double The smallest value, or +INFINITY for an empty array.
+ */
+double num_min(NumericArray *array)
+{
+    return numeric_kernels()->min(array->values, array->size);
+}
+
+/**
+ * @brief Get the largest value of the numeric array.
+ *
+ * @param array The numeric array.
+ * @return double The largest value, or -INFINITY for an empty array.
+ */
+double num_max(NumericArray *array)
+{
+    return numeric_kernels()->max(array->values, array->size);
+}
+
+/**
+ * @brief Count the values that compare true against a threshold.
+ *
+ * @param array The numeric array.
+ * @param op Comparison applied as `value op threshold`.
+ * @param threshold Right-hand side of the comparison.
+ * @return size_t The number of matching values.
+ */
+size_t num_count_if(NumericArray *array, NumericOp op, double threshold)
+{
+    return numeric_kernels()->count_if(array->values, array->size, op,
+                                       threshold);
+}
+
+/**
+ * @brief Create a new array with the values that compare true against a
+ * threshold.
+ *
+ * @param array The numeric array.
+ * @param op Comparison applied as `value op threshold`.
+ * @param threshold Right-hand side of the comparison.
+ * @return NumericArray* A new array with the matching values in order, or
+ * NULL if memory allocation fails.
+ */
+NumericArray *num_filter(NumericArray *array, NumericOp op, double threshold)
+{
+    NumericArray *result = init_numeric_array(array->size);
+    if (!result)
+        return NULL;
+    result->size = numeric_kernels()->filter(array->values, array->size, op,
+                                              threshold, result->values);
+    return result;
+}
+
+/**
+ * @brief Replace every value x of the array by x * scale + offset, in place.
+ *
+ * @param array The numeric array.
+ * @param scale Factor applied to each value.
+ * @param offset Value added after scaling.
+ */
+void num_map_affine(NumericArray *array, double scale, double offset)
+{
+    numeric_kernels()->affine(array->values, array->size, scale, offset);
+}
+
+/**
+ * @brief Free the numeric array.
+ *
+ * @param array The numeric array to free.
+ */
+void free_numeric_array(NumericArray *array)
+{
+    if (!array)
+        return;
+    free(array->values);
+    free(array);
+}
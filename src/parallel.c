@@ -0,0 +1,264 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "linked_list.h"
+#include "retire.h"
+
+typedef struct ReduceTask
+{
+    pthread_t thread;
+    Node *start;
+    size_t count;
+    void *acc;
+    void *(*combine)(void *acc, void *data);
+} ReduceTask;
+
+// Fold one segment of the list into the accumulator of its task
+static void *reduce_segment(void *arg)
+{
+    ReduceTask *task = arg;
+    Node *current = task->start;
+    for (size_t i = 0; i < task->count; i++, current = current->next)
+        task->acc = task->combine(task->acc, current->data);
+    return NULL;
+}
+
+// Number of threads to split `count` elements between: the requested number,
+// or one per online processor when it is 0, but never more than the elements
+static size_t worker_count(size_t requested, size_t count)
+{
+    if (requested == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        requested = online > 0 ? (size_t)online : 1;
+    }
+    if (requested > count)
+        requested = count;
+    return requested ? requested : 1;
+}
+
+/**
+ * @brief Fold the linked list with several threads.
+ *
+ * The list is cut into `nthreads` contiguous segments. Each thread folds its
+ * segment into an accumulator of its own, created by `identity`, so threads
+ * share nothing while they run. Threads are started as soon as the walk
+ * reaches their segment. The partial accumulators are then combined
+ * pairwise as a balanced tree, left to right, so `merge` only needs to be
+ * associative, not commutative.
+ *
+ * `combine` folds an element into an accumulator and returns the result, and
+ * `merge` folds a partial accumulator into another one in the same way, so
+ * accumulators need not have the type of the elements. Partial accumulators
+ * that have been merged are released with `destroy`; the list's free_data
+ * function is never called on them.
+ *
+ * @param[in] list Pointer to the linked list.
+ * @param[in] identity Function returning a new neutral accumulator.
+ * @param[in] combine Function folding an element, its second argument, into
+ * the accumulator given as its first one.
+ * @param[in] merge Associative function folding its second accumulator into
+ * its first one, or NULL to use `combine` when accumulators have the type of
+ * the elements.
+ * @param[in] destroy Function releasing a partial accumulator after it has
+ * been merged, or NULL if they need no release.
+ * @param[in] nthreads Number of threads, or 0 for one per online processor.
+ * @return The final accumulator, or the result of `identity` for an empty
+ * list, or NULL if memory allocation fails.
+ */
+void *parallel_reduce(LinkedList *list, void *(*identity)(void),
+                      void *(*combine)(void *acc, void *data),
+                      void *(*merge)(void *acc, void *other),
+                      void (*destroy)(void *acc), size_t nthreads)
+{
+    size_t count = worker_count(nthreads, list->size);
+    if (count == 1)
+        return reduce(list, identity(), combine);
+
+    if (!merge)
+        merge = combine;
+
+    ReduceTask *tasks = malloc(count * sizeof(ReduceTask));
+    int *started = calloc(count, sizeof(int));
+    if (!tasks || !started)
+    {
+        free(tasks);
+        free(started);
+        return NULL;
+    }
+
+    Node *current = list->head;
+    for (size_t i = 0; i < count; i++)
+    {
+        tasks[i].start = current;
+        tasks[i].count =
+            list->size / count + (i < list->size % count ? 1 : 0);
+        tasks[i].acc = identity();
+        tasks[i].combine = combine;
+        started[i] = pthread_create(&tasks[i].thread, NULL, reduce_segment,
+                                    &tasks[i])
+            == 0;
+        for (size_t j = 0; j < tasks[i].count; j++)
+            current = current->next;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (started[i])
+            pthread_join(tasks[i].thread, NULL);
+        else
+            reduce_segment(&tasks[i]);
+    }
+
+    for (size_t step = 1; step < count; step *= 2)
+    {
+        for (size_t i = 0; i + step < count; i += 2 * step)
+        {
+            tasks[i].acc = merge(tasks[i].acc, tasks[i + step].acc);
+            if (destroy)
+                destroy(tasks[i + step].acc);
+        }
+    }
+
+    void *acc = tasks[0].acc;
+    free(tasks);
+    free(started);
+    return acc;
+}
+
+typedef struct BucketChain
+{
+    Node *head;
+    Node *tail;
+    size_t size;
+} BucketChain;
+
+typedef struct GroupTask
+{
+    pthread_t thread;
+    Node *start;
+    size_t count;
+    size_t (*bucket)(void *data);
+    size_t nbuckets;
+    BucketChain *chains; // one per bucket, private to the task
+} GroupTask;
+
+// Relink the nodes of one segment into the bucket chains of its task. Only
+// the nodes of the segment are touched, so tasks never share a node.
+static void *group_segment(void *arg)
+{
+    GroupTask *task = arg;
+    Node *current = task->start;
+    for (size_t i = 0; i < task->count; i++)
+    {
+        Node *next = current->next;
+        BucketChain *chain =
+            &task->chains[task->bucket(current->data) % task->nbuckets];
+        if (chain->tail)
+            chain->tail->next = current;
+        else
+            chain->head = current;
+        chain->tail = current;
+        chain->size++;
+        current = next;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Distribute the elements of the linked list into buckets with
+ * several threads.
+ *
+ * This gives the same result as group_by. The list is cut into `nthreads`
+ * contiguous segments, and each thread relinks the nodes of its segment into
+ * bucket chains of its own, so threads share nothing while they run. The
+ * chains of every bucket are then concatenated in segment order, which keeps
+ * the original order within each bucket. `bucket` is called concurrently
+ * from several threads.
+ *
+ * @param[in] list Pointer to the linked list to distribute.
+ * @param[in] bucket Function returning the bucket of an element. Values of
+ * `nbuckets` or more are taken modulo `nbuckets`.
+ * @param[in] nbuckets Number of buckets, at least 1.
+ * @param[in] nthreads Number of threads, or 0 for one per online processor.
+ * @return An array of `nbuckets` new linked lists, as for group_by, or NULL
+ * if memory allocation fails, in which case `list` is left unchanged.
+ */
+LinkedList **group_by_parallel(LinkedList *list,
+                               size_t (*bucket)(void *data), size_t nbuckets,
+                               size_t nthreads)
+{
+    if (!list || !bucket || nbuckets == 0)
+        return NULL;
+
+    size_t count = worker_count(nthreads, list->size);
+    if (count == 1)
+        return group_by(list, bucket, nbuckets);
+
+    LinkedList **buckets = init_bucket_lists(nbuckets, list->free_data);
+    GroupTask *tasks = malloc(count * sizeof(GroupTask));
+    BucketChain *chains = calloc(count * nbuckets, sizeof(BucketChain));
+    int *started = calloc(count, sizeof(int));
+    if (!buckets || !tasks || !chains || !started || list_unshare(list) != 0)
+    {
+        for (size_t i = 0; buckets && i < nbuckets; i++)
+            free_linked_list(buckets[i]);
+        free(buckets);
+        free(tasks);
+        free(chains);
+        free(started);
+        return NULL;
+    }
+
+    for (size_t b = 0; b < nbuckets; b++)
+        retire_adopt(buckets[b], list);
+
+    // Find every segment before starting any thread, since threads relink
+    // the nodes the walk would go through
+    Node *current = list->head;
+    for (size_t i = 0; i < count; i++)
+    {
+        tasks[i].start = current;
+        tasks[i].count =
+            list->size / count + (i < list->size % count ? 1 : 0);
+        tasks[i].bucket = bucket;
+        tasks[i].nbuckets = nbuckets;
+        tasks[i].chains = &chains[i * nbuckets];
+        for (size_t j = 0; j < tasks[i].count; j++)
+            current = current->next;
+    }
+    take_nodes(list);
+
+    for (size_t i = 0; i < count; i++)
+        started[i] = pthread_create(&tasks[i].thread, NULL, group_segment,
+                                    &tasks[i])
+            == 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (started[i])
+            pthread_join(tasks[i].thread, NULL);
+        else
+            group_segment(&tasks[i]);
+    }
+
+    for (size_t b = 0; b < nbuckets; b++)
+    {
+        Node **tail = &buckets[b]->head;
+        for (size_t i = 0; i < count; i++)
+        {
+            BucketChain *chain = &tasks[i].chains[b];
+            if (!chain->head)
+                continue;
+            *tail = chain->head;
+            tail = &chain->tail->next;
+            buckets[b]->size += chain->size;
+        }
+        *tail = NULL;
+    }
+
+    free(tasks);
+    free(chains);
+    free(started);
+    return buckets;
+}
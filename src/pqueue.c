@@ -0,0 +1,334 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "../include/utils.h"
+
+// Number of children per heap node. A 4-ary heap is half as deep as a binary
+// one, so pushes and decrease_key do half the comparisons and moves, and a
+// sift down step scans four adjacent entries instead of two.
+#define PQ_ARITY 4
+#define PQ_MIN_CAPACITY 16
+
+// Marks entries pushed without a handle, and ends the free handle list
+#define NO_HANDLE SIZE_MAX
+
+typedef struct PQEntry
+{
+    void *data;
+    size_t handle;
+} PQEntry;
+
+struct PriorityQueue
+{
+    PQEntry *entries;
+    size_t size;
+    size_t capacity;
+    // Heap index of the entry of each handle in use. Unused handles are
+    // chained through it from free_handle.
+    size_t *positions;
+    size_t handle_count;
+    size_t handle_capacity;
+    size_t free_handle;
+    int (*cmp)(const void *, const void *);
+    void (*free_data)(void *data);
+};
+
+/**
+ * @brief Initialize a new priority queue.
+ *
+ * The queue is a 4-ary min-heap stored in an array: pq_pop returns the
+ * smallest element according to `cmp`. Elements that compare equal come out
+ * in an unspecified order.
+ *
+ * @param[in] cmp Comparison function that returns <0, 0, or >0 based on
+ * element comparison, as for sort.
+ * @param[in] free_data Function pointer used to free the elements left in the
+ * queue when it is destroyed, or NULL.
+ * @return Pointer to the newly created PriorityQueue, or NULL if memory
+ * allocation fails.
+ */
+PriorityQueue *init_pqueue(int (*cmp)(const void *, const void *),
+                           void (*free_data)(void *))
+{
+    if (!cmp)
+        return NULL;
+
+    PriorityQueue *pq = malloc(sizeof(PriorityQueue));
+    if (!pq)
+        return NULL;
+    pq->entries = NULL;
+    pq->size = 0;
+    pq->capacity = 0;
+    pq->positions = NULL;
+    pq->handle_count = 0;
+    pq->handle_capacity = 0;
+    pq->free_handle = NO_HANDLE;
+    pq->cmp = cmp;
+    pq->free_data = free_data;
+    return pq;
+}
+
+// Make room for at least `needed` entries
+static int reserve_entries(PriorityQueue *pq, size_t needed)
+{
+    if (needed <= pq->capacity)
+        return 0;
+
+    size_t capacity = pq->capacity ? pq->capacity : PQ_MIN_CAPACITY;
+    while (capacity < needed)
+        capacity *= 2;
+    PQEntry *entries = realloc(pq->entries, capacity * sizeof(PQEntry));
+    if (!entries)
+        return -1;
+    pq->entries = entries;
+    pq->capacity = capacity;
+    return 0;
+}
+
+// Store an entry at a heap index, keeping its handle up to date
+static void place(PriorityQueue *pq, size_t index, PQEntry entry)
+{
+    pq->entries[index] = entry;
+    if (entry.handle != NO_HANDLE)
+        pq->positions[entry.handle] = index;
+}
+
+// Move the entry at `index` up while it is smaller than its parent
+static void pq_sift_up(PriorityQueue *pq, size_t index)
+{
+    PQEntry entry = pq->entries[index];
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / PQ_ARITY;
+        if (pq->cmp(entry.data, pq->entries[parent].data) >= 0)
+            break;
+        place(pq, index, pq->entries[parent]);
+        index = parent;
+    }
+    place(pq, index, entry);
+}
+
+// Move the entry at `index` down while one of its children is smaller
+static void pq_sift_down(PriorityQueue *pq, size_t index)
+{
+    PQEntry entry = pq->entries[index];
+    for (;;)
+    {
+        size_t first = index * PQ_ARITY + 1;
+        if (first >= pq->size)
+            break;
+
+        size_t last = first + PQ_ARITY < pq->size ? first + PQ_ARITY : pq->size;
+        size_t smallest = first;
+        for (size_t child = first + 1; child < last; child++)
+        {
+            if (pq->cmp(pq->entries[child].data,
+                        pq->entries[smallest].data) < 0)
+                smallest = child;
+        }
+        if (pq->cmp(pq->entries[smallest].data, entry.data) >= 0)
+            break;
+        place(pq, index, pq->entries[smallest]);
+        index = smallest;
+    }
+    place(pq, index, entry);
+}
+
+// Add an entry at the bottom of the heap and restore the heap order
+static int push_entry(PriorityQueue *pq, void *data, size_t handle)
+{
+    if (reserve_entries(pq, pq->size + 1) != 0)
+        return -1;
+    pq->entries[pq->size] = (PQEntry){data, handle};
+    pq->size++;
+    pq_sift_up(pq, pq->size - 1);
+    return 0;
+}
+
+/**
+ * @brief Add an element to the priority queue.
+ *
+ * @param[in] pq Pointer to the priority queue.
+ * @param[in] data Pointer to the element to add.
+ */
+void pq_push(PriorityQueue *pq, void *data)
+{
+    if (!pq)
+        return;
+    push_entry(pq, data, NO_HANDLE);
+}
+
+/**
+ * @brief Add an element to the priority queue and get a handle to it.
+ *
+ * The handle identifies the element for pq_decrease_key until it is popped,
+ * after which the handle may be reused for another element.
+ *
+ * @param[in] pq Pointer to the priority queue.
+ * @param[in] data Pointer to the element to add.
+ * @param[out] handle Receives the handle of the element.
+ * @return 0 on success, or -1 if memory allocation fails.
+ */
+int pq_push_handle(PriorityQueue *pq, void *data, PQHandle *handle)
+{
+    if (!pq || !handle)
+        return -1;
+
+    size_t id = pq->free_handle;
+    if (id == NO_HANDLE)
+    {
+        if (pq->handle_count == pq->handle_capacity)
+        {
+            size_t capacity =
+                pq->handle_capacity ? pq->handle_capacity * 2 : PQ_MIN_CAPACITY;
+            size_t *positions =
+                realloc(pq->positions, capacity * sizeof(size_t));
+            if (!positions)
+                return -1;
+            pq->positions = positions;
+            pq->handle_capacity = capacity;
+        }
+        id = pq->handle_count++;
+        pq->positions[id] = NO_HANDLE;
+    }
+
+    // Take the handle off the free list only once the push cannot fail
+    size_t next_free = pq->positions[id];
+    if (push_entry(pq, data, id) != 0)
+        return -1;
+    if (id == pq->free_handle)
+        pq->free_handle = next_free;
+    *handle = id;
+    return 0;
+}
+
+/**
+ * @brief Add several elements to the priority queue at once.
+ *
+ * When the elements outnumber those already queued, the heap is rebuilt
+ * bottom-up in O(n) instead of pushing the elements one by one in
+ * O(n log n).
+ *
+ * @param[in] pq Pointer to the priority queue.
+ * @param[in] items Array of pointers to the elements to add.
+ * @param[in] count Number of entries in `items`.
+ * @return 0 on success, or -1 if memory allocation fails, in which case no
+ * element was added.
+ */
+int pq_push_n(PriorityQueue *pq, void **items, size_t count)
+{
+    if (!pq || (count && !items))
+        return -1;
+    if (reserve_entries(pq, pq->size + count) != 0)
+        return -1;
+
+    size_t old_size = pq->size;
+    for (size_t i = 0; i < count; i++)
+        pq->entries[old_size + i] = (PQEntry){items[i], NO_HANDLE};
+    pq->size += count;
+
+    if (count < old_size)
+    {
+        for (size_t i = old_size; i < pq->size; i++)
+            pq_sift_up(pq, i);
+    }
+    else if (pq->size > 1)
+    {
+        for (size_t i = (pq->size - 2) / PQ_ARITY + 1; i-- > 0;)
+            pq_sift_down(pq, i);
+    }
+    return 0;
+}
+
+/**
+ * @brief Get the smallest element without removing it.
+ *
+ * @param[in] pq Pointer to the priority queue.
+ * @return Pointer to the smallest element, or NULL if the queue is empty.
+ */
+void *pq_peek(PriorityQueue *pq)
+{
+    if (!pq || pq->size == 0)
+        return NULL;
+    return pq->entries[0].data;
+}
+
+/**
+ * @brief Remove the smallest element from the priority queue.
+ *
+ * @param[in] pq Pointer to the priority queue.
+ * @return Pointer to the removed element, or NULL if the queue is empty.
+ * Note: The caller is responsible for freeing the element if necessary.
+ */
+void *pq_pop(PriorityQueue *pq)
+{
+    if (!pq || pq->size == 0)
+        return NULL;
+
+    PQEntry top = pq->entries[0];
+    if (top.handle != NO_HANDLE)
+    {
+        pq->positions[top.handle] = pq->free_handle;
+        pq->free_handle = top.handle;
+    }
+
+    pq->size--;
+    if (pq->size > 0)
+    {
+        pq->entries[0] = pq->entries[pq->size];
+        pq_sift_down(pq, 0);
+    }
+    return top.data;
+}
+
+/**
+ * @brief Restore the queue order after an element became smaller.
+ *
+ * Call this after changing an element in place so that it compares smaller
+ * than before, for example when a shorter path to a vertex is found.
+ *
+ * @param[in] pq Pointer to the priority queue.
+ * @param[in] handle Handle of the element, as returned by pq_push_handle.
+ * It must still be in the queue.
+ */
+void pq_decrease_key(PriorityQueue *pq, PQHandle handle)
+{
+    if (!pq || handle >= pq->handle_count)
+        return;
+
+    size_t index = pq->positions[handle];
+    if (index < pq->size && pq->entries[index].handle == handle)
+        pq_sift_up(pq, index);
+}
+
+/**
+ * @brief Get the number of elements in the priority queue.
+ *
+ * @param[in] pq Pointer to the priority queue.
+ * @return The number of elements, or 0 if `pq` is NULL.
+ */
+size_t pq_length(PriorityQueue *pq)
+{
+    return pq ? pq->size : 0;
+}
+
+/**
+ * @brief Free the priority queue and the elements left in it.
+ *
+ * @param[in] pq Pointer to the priority queue to free. Each remaining element
+ * is freed with the free_data function given to init_pqueue, if not NULL.
+ */
+void free_pqueue(PriorityQueue *pq)
+{
+    if (!pq)
+        return;
+
+    if (pq->free_data)
+    {
+        for (size_t i = 0; i < pq->size; i++)
+            pq->free_data(pq->entries[i].data);
+    }
+    free(pq->entries);
+    free(pq->positions);
+    free(pq);
+}
@@ -0,0 +1,189 @@
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "linked_list.h"
+#include "memory.h"
+#include "reclaimer.h"
+#include "retire.h"
+#include "stack.h"
+
+// Number of chains waiting for the reclaimer before callers have to wait
+#define RECLAIM_QUEUE_CAPACITY 64
+
+typedef struct ReclaimJob
+{
+    Node *head;
+    void (*free_data)(void *data);
+} ReclaimJob;
+
+// A single background thread frees the chains handed to it. It is started by
+// the first asynchronous free and runs until utils_reclaimer_drain.
+static pthread_mutex_t reclaim_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_not_empty = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t queue_not_full = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t reclaimer_stopped = PTHREAD_COND_INITIALIZER;
+static ReclaimJob queue[RECLAIM_QUEUE_CAPACITY];
+static size_t queue_first = 0;
+static size_t queue_count = 0;
+static pthread_t reclaimer;
+static int running = 0;
+static int stopping = 0;
+
+static void *reclaim_worker(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&reclaim_lock);
+    for (;;)
+    {
+        while (queue_count == 0 && !stopping)
+            pthread_cond_wait(&queue_not_empty, &reclaim_lock);
+        if (queue_count == 0)
+            break;
+
+        ReclaimJob job = queue[queue_first];
+        queue_first = (queue_first + 1) % RECLAIM_QUEUE_CAPACITY;
+        queue_count--;
+        pthread_cond_signal(&queue_not_full);
+
+        pthread_mutex_unlock(&reclaim_lock);
+        free_chain(job.head, job.free_data);
+        pthread_mutex_lock(&reclaim_lock);
+    }
+    pthread_mutex_unlock(&reclaim_lock);
+    return NULL;
+}
+
+/**
+ * @brief Hand a chain of nodes over to the reclaimer thread.
+ *
+ * The reclaimer is started if needed. When the queue is full, the caller
+ * waits for a slot, unless it is the reclaimer itself; when the reclaimer is
+ * being drained or cannot be started, or when it would have to wait for
+ * itself, the chain is freed right away by the caller.
+ *
+ * @param head First node of the chain, or NULL.
+ * @param free_data Function used to free the data of each node, or NULL.
+ */
+void reclaim_chain_async(Node *head, void (*free_data)(void *data))
+{
+    if (!head)
+        return;
+
+    pthread_mutex_lock(&reclaim_lock);
+    if (!running && !stopping)
+        running = pthread_create(&reclaimer, NULL, reclaim_worker, NULL) == 0;
+    if (!running || stopping)
+    {
+        pthread_mutex_unlock(&reclaim_lock);
+        free_chain(head, free_data);
+        return;
+    }
+
+    while (queue_count == RECLAIM_QUEUE_CAPACITY)
+    {
+        // A free_data function running on the reclaimer would wait for
+        // itself to make room
+        if (pthread_equal(pthread_self(), reclaimer))
+        {
+            pthread_mutex_unlock(&reclaim_lock);
+            free_chain(head, free_data);
+            return;
+        }
+        pthread_cond_wait(&queue_not_full, &reclaim_lock);
+    }
+    size_t slot = (queue_first + queue_count) % RECLAIM_QUEUE_CAPACITY;
+    queue[slot].head = head;
+    queue[slot].free_data = free_data;
+    queue_count++;
+    pthread_cond_signal(&queue_not_empty);
+    pthread_mutex_unlock(&reclaim_lock);
+}
+
+/**
+ * @brief Free a linked list in the background.
+ *
+ * The node chain is detached and queued for the reclaimer thread, so the
+ * caller only pays for releasing the list header. The data is freed with the
+ * list's free_data function as in free_linked_list, but later and from the
+ * reclaimer thread, so it must not be used anymore nor depend on the
+ * caller's thread. Call utils_reclaimer_drain before exiting to make sure
+ * everything was freed. Clones, and lists whose elements may still be read
+ * by copy-on-write clones, are freed right away, as free_linked_list does.
+ *
+ * @param[in] list Pointer to the linked list to free.
+ */
+void free_linked_list_async(LinkedList *list)
+{
+    if (!list)
+        return;
+
+    // Clones still reading the data would race with the reclaimer, and
+    // clones themselves have to leave their generation
+    if ((list->share && atomic_load(&list->share->refs) > 1)
+        || list->generation || retire_pending(list))
+    {
+        free_linked_list(list);
+        return;
+    }
+    list_unshare(list);
+
+    Node *head = list->head;
+    void (*free_data)(void *) = list->free_data;
+    retire_detach(list);
+    free(list->sorted_index);
+    list_detach_index(list);
+    memory_registry_remove(list->memory_entry);
+    free(list);
+    reclaim_chain_async(head, free_data);
+}
+
+/**
+ * @brief Frees a stack in the background.
+ *
+ * Works like free_linked_list_async: the node chain is queued for the
+ * reclaimer thread and only the stack header is released by the caller.
+ *
+ * @param stack The stack to free.
+ */
+void free_stack_async(Stack *stack)
+{
+    if (!stack)
+        return;
+
+    Node *head = stack->head;
+    void (*free_data)(void *) = stack->free_data;
+    memory_registry_remove(stack->memory_entry);
+    free(stack);
+    reclaim_chain_async(head, free_data);
+}
+
+/**
+ * @brief Wait until every container queued for background freeing is freed.
+ *
+ * The reclaimer thread is stopped once the queue is empty, and started again
+ * by the next asynchronous free. Containers freed asynchronously while the
+ * drain is in progress are freed by the caller instead.
+ */
+void utils_reclaimer_drain(void)
+{
+    pthread_mutex_lock(&reclaim_lock);
+    if (running && !stopping)
+    {
+        stopping = 1;
+        pthread_cond_signal(&queue_not_empty);
+        pthread_mutex_unlock(&reclaim_lock);
+
+        pthread_join(reclaimer, NULL);
+
+        pthread_mutex_lock(&reclaim_lock);
+        running = 0;
+        stopping = 0;
+        pthread_cond_broadcast(&reclaimer_stopped);
+    }
+    else
+    {
+        while (running)
+            pthread_cond_wait(&reclaimer_stopped, &reclaim_lock);
+    }
+    pthread_mutex_unlock(&reclaim_lock);
+}
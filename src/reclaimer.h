@@ -0,0 +1,8 @@
+#ifndef RECLAIMER_H
+#define RECLAIMER_H
+
+#include "node.h"
+
+void reclaim_chain_async(Node *head, void (*free_data)(void *data));
+
+#endif
@@ -0,0 +1,306 @@
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "retire.h"
+
+/*
+ * Copy-on-write clones read the elements of the list they were cloned from
+ * without owning them, so an element that list removes, or frees with
+ * itself, may still be in use by a clone. The lists that may hold such
+ * elements, namely the cloned list, its clones and the lists that took
+ * elements from them, share a lineage. Its clones are grouped in
+ * generations: while clones of the lineage are alive, the elements its
+ * lists release are kept by the newest generation, and only freed once
+ * every clone of that generation and of the older ones has been freed.
+ * Clones created afterwards cannot see them, so they start a new
+ * generation and do not hold them back.
+ *
+ * Lists that were never cloned have no lineage and free their elements
+ * right away.
+ */
+
+typedef struct Retired
+{
+    void *data;
+    void (*free_data)(void *data);
+} Retired;
+
+struct Generation
+{
+    size_t readers; // clones of this generation still alive
+    Retired *items; // elements released while it was the newest one
+    size_t count;
+    size_t capacity;
+    struct Generation *next; // newer generation
+};
+
+struct CloneLineage
+{
+    size_t refs; // lists using the lineage, and lineages forwarding to it
+    struct Generation *oldest;
+    struct Generation *newest;
+    // Lineage this one was merged into, when a list took elements from two
+    // lineages
+    struct CloneLineage *forward;
+};
+
+#define MIN_RETIRED 16
+
+// Only taken by lists that have a lineage
+static pthread_mutex_t retire_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct CloneLineage *resolve(struct CloneLineage *lineage)
+{
+    while (lineage->forward)
+        lineage = lineage->forward;
+    return lineage;
+}
+
+// Drop a reference to a lineage, and to the ones it forwards to
+static void release_lineage(struct CloneLineage *lineage)
+{
+    while (lineage && --lineage->refs == 0)
+    {
+        struct CloneLineage *forward = lineage->forward;
+        free(lineage);
+        lineage = forward;
+    }
+}
+
+// Detach the generations of the lineage that no clone can read anymore
+static struct Generation *take_drained(struct CloneLineage *lineage)
+{
+    struct Generation *drained = NULL;
+    struct Generation **drained_tail = &drained;
+    while (lineage->oldest && lineage->oldest->readers == 0)
+    {
+        *drained_tail = lineage->oldest;
+        drained_tail = &lineage->oldest->next;
+        lineage->oldest = lineage->oldest->next;
+    }
+    *drained_tail = NULL;
+    if (!lineage->oldest)
+        lineage->newest = NULL;
+    return drained;
+}
+
+// Free the elements of drained generations, outside of the lock since their
+// free_data functions may free lists in turn
+static void free_drained(struct Generation *drained)
+{
+    while (drained)
+    {
+        struct Generation *next = drained->next;
+        for (size_t i = 0; i < drained->count; i++)
+            drained->items[i].free_data(drained->items[i].data);
+        free(drained->items);
+        free(drained);
+        drained = next;
+    }
+}
+
+/**
+ * @brief Register a new copy-on-write clone of a list.
+ *
+ * @param clone The new clone.
+ * @param list The list it was cloned from, possibly a clone itself.
+ * @return 0 on success, or -1 if memory allocation fails.
+ */
+int retire_clone(LinkedList *clone, LinkedList *list)
+{
+    pthread_mutex_lock(&retire_lock);
+    if (!list->lineage)
+    {
+        list->lineage = calloc(1, sizeof(struct CloneLineage));
+        if (!list->lineage)
+        {
+            pthread_mutex_unlock(&retire_lock);
+            return -1;
+        }
+        list->lineage->refs = 1;
+    }
+
+    struct CloneLineage *lineage = resolve(list->lineage);
+    struct Generation *generation = list->generation;
+    if (!generation && lineage->newest && lineage->newest->count == 0)
+        generation = lineage->newest;
+    if (!generation)
+    {
+        generation = calloc(1, sizeof(struct Generation));
+        if (!generation)
+        {
+            pthread_mutex_unlock(&retire_lock);
+            return -1;
+        }
+        if (lineage->newest)
+            lineage->newest->next = generation;
+        else
+            lineage->oldest = generation;
+        lineage->newest = generation;
+    }
+    generation->readers++;
+    lineage->refs++;
+    clone->lineage = lineage;
+    clone->generation = generation;
+    pthread_mutex_unlock(&retire_lock);
+    return 0;
+}
+
+/**
+ * @brief Make a list release its elements like a list it took nodes from.
+ *
+ * Called when nodes move from `source` to `list`, so that the elements keep
+ * waiting for the clones of `source`. When both lists have a lineage, the
+ * lineage of `source` is merged into the one of `list`: its generations are
+ * queued after the others, so they are drained in an order that is safe for
+ * both.
+ *
+ * @param list The list receiving the nodes.
+ * @param source The list the nodes come from.
+ */
+void retire_adopt(LinkedList *list, LinkedList *source)
+{
+    if (!source->lineage || list == source)
+        return;
+
+    pthread_mutex_lock(&retire_lock);
+    struct CloneLineage *from = resolve(source->lineage);
+    if (!list->lineage)
+    {
+        list->lineage = from;
+        from->refs++;
+    }
+    else
+    {
+        struct CloneLineage *into = resolve(list->lineage);
+        if (into != from)
+        {
+            if (from->oldest)
+            {
+                if (into->newest)
+                    into->newest->next = from->oldest;
+                else
+                    into->oldest = from->oldest;
+                into->newest = from->newest;
+            }
+            from->oldest = NULL;
+            from->newest = NULL;
+            from->forward = into;
+            into->refs++;
+        }
+    }
+    pthread_mutex_unlock(&retire_lock);
+}
+
+/**
+ * @brief Unregister a list that is being freed.
+ *
+ * A clone leaves its generation, and the elements that no remaining clone
+ * can read are freed.
+ *
+ * @param list The list, with or without a lineage.
+ */
+void retire_detach(LinkedList *list)
+{
+    if (!list->lineage)
+        return;
+
+    pthread_mutex_lock(&retire_lock);
+    struct Generation *drained = NULL;
+    if (list->generation)
+    {
+        list->generation->readers--;
+        drained = take_drained(resolve(list->lineage));
+    }
+    release_lineage(list->lineage);
+    list->lineage = NULL;
+    list->generation = NULL;
+    pthread_mutex_unlock(&retire_lock);
+
+    free_drained(drained);
+}
+
+/**
+ * @brief Free an element released by a list, once no clone can read it.
+ *
+ * @param list The list releasing the element. Nothing is done when its
+ * free_data function is NULL.
+ * @param data The element.
+ */
+void retire_data(LinkedList *list, void *data)
+{
+    if (!list->free_data)
+        return;
+    if (!list->lineage)
+    {
+        list->free_data(data);
+        return;
+    }
+
+    pthread_mutex_lock(&retire_lock);
+    struct Generation *generation = resolve(list->lineage)->newest;
+    if (generation && generation->count == generation->capacity)
+    {
+        size_t capacity =
+            generation->capacity ? 2 * generation->capacity : MIN_RETIRED;
+        Retired *items =
+            realloc(generation->items, capacity * sizeof(Retired));
+        if (!items)
+        {
+            // Freeing the element now could pull it from under a clone, so
+            // it is leaked instead
+            pthread_mutex_unlock(&retire_lock);
+            return;
+        }
+        generation->items = items;
+        generation->capacity = capacity;
+    }
+    if (generation)
+        generation->items[generation->count++] =
+            (Retired){data, list->free_data};
+    pthread_mutex_unlock(&retire_lock);
+
+    if (!generation)
+        list->free_data(data);
+}
+
+/**
+ * @brief Free a node chain of a list, releasing its data with retire_data.
+ *
+ * @param list The list the chain belonged to.
+ * @param head First node of the chain.
+ */
+void retire_chain(LinkedList *list, Node *head)
+{
+    if (!list->lineage)
+    {
+        free_chain(head, list->free_data);
+        return;
+    }
+
+    while (head)
+    {
+        Node *next = head->next;
+        retire_data(list, head->data);
+        free_node(head);
+        head = next;
+    }
+}
+
+/**
+ * @brief Check whether the elements a list releases are held back for
+ * clones.
+ *
+ * @param list The list.
+ * @return Non-zero while clones of its lineage are alive.
+ */
+int retire_pending(LinkedList *list)
+{
+    if (!list->lineage)
+        return 0;
+
+    pthread_mutex_lock(&retire_lock);
+    int pending = resolve(list->lineage)->oldest != NULL;
+    pthread_mutex_unlock(&retire_lock);
+    return pending;
+}
@@ -0,0 +1,13 @@
+#ifndef RETIRE_H
+#define RETIRE_H
+
+#include "linked_list.h"
+
+int retire_clone(LinkedList *clone, LinkedList *list);
+void retire_adopt(LinkedList *list, LinkedList *source);
+void retire_detach(LinkedList *list);
+void retire_data(LinkedList *list, void *data);
+void retire_chain(LinkedList *list, Node *head);
+int retire_pending(LinkedList *list);
+
+#endif
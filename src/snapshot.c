@@ -0,0 +1,386 @@
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "linked_list.h"
+
+/*
+ * Snapshot file layout, in native byte order:
+ *
+ *   SnapshotHeader
+ *   record table, starting at table_offset (variable-size records only):
+ *     one SnapshotRecord per element, pointing into the data section
+ *   data section, starting at data_offset
+ *
+ * Inline snapshots store element_size bytes per element back to back and
+ * have no record table. Every record starts on an 8-byte boundary.
+ */
+
+#define SNAPSHOT_MAGIC "LUSNAP01"
+#define SNAPSHOT_ALIGN 8
+#define SNAPSHOT_BUFFER_SIZE (1 << 20)
+
+typedef struct SnapshotHeader
+{
+    char magic[8];
+    uint64_t count;
+    uint64_t element_size; // 0 for variable-size records
+    uint64_t data_offset;
+    uint64_t table_offset;
+} SnapshotHeader;
+
+typedef struct SnapshotRecord
+{
+    uint64_t offset;
+    uint64_t size;
+} SnapshotRecord;
+
+struct ListSnapshot
+{
+    unsigned char *map;
+    size_t map_size;
+    const SnapshotHeader *header;
+    const SnapshotRecord *records;
+};
+
+// Buffered writer over a region of the file, flushed with pwrite so that
+// the data section and the record table can be filled in one pass
+typedef struct FileRegion
+{
+    int fd;
+    off_t offset;
+    unsigned char *buffer;
+    size_t used;
+} FileRegion;
+
+static int region_flush(FileRegion *region)
+{
+    size_t done = 0;
+    while (done < region->used)
+    {
+        ssize_t written = pwrite(region->fd, region->buffer + done,
+                                 region->used - done, region->offset);
+        if (written < 0)
+            return -1;
+        done += (size_t)written;
+        region->offset += written;
+    }
+    region->used = 0;
+    return 0;
+}
+
+static int region_write(FileRegion *region, const void *bytes, size_t size)
+{
+    const unsigned char *source = bytes;
+    while (size)
+    {
+        size_t chunk = SNAPSHOT_BUFFER_SIZE - region->used;
+        if (chunk > size)
+            chunk = size;
+        memcpy(region->buffer + region->used, source, chunk);
+        region->used += chunk;
+        source += chunk;
+        size -= chunk;
+        if (region->used == SNAPSHOT_BUFFER_SIZE && region_flush(region) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+static size_t align_up(size_t size)
+{
+    return (size + SNAPSHOT_ALIGN - 1) & ~(size_t)(SNAPSHOT_ALIGN - 1);
+}
+
+// Write the snapshot of `list`, serializing with `serialize` or, when it is
+// NULL, copying element_size bytes from each payload
+static int save(LinkedList *list, const char *path,
+                size_t (*serialize)(const void *, void *, size_t),
+                size_t element_size)
+{
+    static const unsigned char padding[SNAPSHOT_ALIGN];
+
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.count = list->size;
+    header.element_size = element_size;
+    header.table_offset = serialize ? align_up(sizeof(SnapshotHeader)) : 0;
+    header.data_offset =
+        serialize ? align_up(header.table_offset
+                             + list->size * sizeof(SnapshotRecord))
+                  : align_up(sizeof(SnapshotHeader));
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return -1;
+
+    FileRegion data = {fd, (off_t)header.data_offset,
+                       malloc(SNAPSHOT_BUFFER_SIZE), 0};
+    FileRegion table = {fd, (off_t)header.table_offset,
+                        serialize ? malloc(SNAPSHOT_BUFFER_SIZE) : NULL, 0};
+    size_t capacity = serialize ? 256 : 0;
+    unsigned char *scratch = serialize ? malloc(capacity) : NULL;
+    int status = data.buffer && (!serialize || (table.buffer && scratch)) ? 0
+                                                                         : -1;
+
+    uint64_t position = 0;
+    for (Node *current = list->head; current && status == 0;
+         current = current->next)
+    {
+        if (!serialize)
+        {
+            status = region_write(&data, current->data, element_size);
+            continue;
+        }
+
+        size_t size = serialize(current->data, scratch, capacity);
+        if (size > capacity)
+        {
+            unsigned char *larger = realloc(scratch, size);
+            if (!larger)
+            {
+                status = -1;
+                break;
+            }
+            scratch = larger;
+            capacity = size;
+            serialize(current->data, scratch, capacity);
+        }
+
+        SnapshotRecord record = {position, size};
+        size_t padded = align_up(size);
+        if (region_write(&table, &record, sizeof(record)) < 0
+            || region_write(&data, scratch, size) < 0
+            || region_write(&data, padding, padded - size) < 0)
+            status = -1;
+        position += padded;
+    }
+
+    if (status == 0)
+        status = region_flush(&data);
+    if (status == 0 && serialize)
+        status = region_flush(&table);
+    if (status == 0
+        && pwrite(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header))
+        status = -1;
+
+    free(scratch);
+    free(data.buffer);
+    free(table.buffer);
+    if (close(fd) < 0)
+        status = -1;
+    return status;
+}
+
+/**
+ * @brief Save the linked list to a binary snapshot file.
+ *
+ * Each payload is turned into bytes by `serialize`, which is called as
+ * `serialize(data, buffer, capacity)` and must return the number of bytes
+ * the payload needs. It only writes to `buffer` when that number fits in
+ * `capacity`; otherwise it is called again with a large enough buffer. The
+ * file is written with large buffered writes in a single walk of the list.
+ *
+ * @param[in] list Pointer to the linked list to save.
+ * @param[in] path Path of the snapshot file, created or truncated.
+ * @param[in] serialize Function writing the bytes of one payload.
+ * @return 0 on success, -1 if the file could not be written.
+ */
+int list_save(LinkedList *list, const char *path,
+              size_t (*serialize)(const void *data, void *buffer,
+                                  size_t capacity))
+{
+    if (!list || !path || !serialize)
+        return -1;
+    return save(list, path, serialize, 0);
+}
+
+/**
+ * @brief Save a list of fixed-size payloads to a binary snapshot file.
+ *
+ * Each payload is copied as `element_size` raw bytes and stored inline, with
+ * no per-element record, which suits plain numbers and flat structs.
+ *
+ * @param[in] list Pointer to the linked list to save.
+ * @param[in] path Path of the snapshot file, created or truncated.
+ * @param[in] element_size Size in bytes of every payload, greater than 0.
+ * @return 0 on success, -1 if the file could not be written.
+ */
+int list_save_inline(LinkedList *list, const char *path, size_t element_size)
+{
+    if (!list || !path || element_size == 0)
+        return -1;
+    return save(list, path, NULL, element_size);
+}
+
+// Check that the header and the record table describe the mapped file
+static int snapshot_valid(const ListSnapshot *snapshot)
+{
+    const SnapshotHeader *header = snapshot->header;
+    uint64_t size = snapshot->map_size;
+
+    if (size < sizeof(SnapshotHeader)
+        || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0
+        || header->data_offset > size)
+        return 0;
+
+    uint64_t available = size - header->data_offset;
+    if (header->element_size)
+        return header->count <= available / header->element_size;
+
+    if (header->table_offset > size
+        || header->count > (size - header->table_offset)
+                / sizeof(SnapshotRecord)
+        || header->table_offset % SNAPSHOT_ALIGN != 0)
+        return 0;
+
+    const SnapshotRecord *records =
+        (const SnapshotRecord *)(snapshot->map + header->table_offset);
+    for (uint64_t i = 0; i < header->count; i++)
+    {
+        if (records[i].offset > available
+            || records[i].size > available - records[i].offset)
+            return 0;
+    }
+    return 1;
+}
+
+static ListSnapshot *map_snapshot(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    struct stat info;
+    ListSnapshot *snapshot = malloc(sizeof(ListSnapshot));
+    if (!snapshot || fstat(fd, &info) < 0 || info.st_size == 0)
+    {
+        free(snapshot);
+        close(fd);
+        return NULL;
+    }
+
+    // Private writable mapping: payloads can be modified in place without
+    // touching the file, pages are only copied when written to
+    snapshot->map_size = (size_t)info.st_size;
+    snapshot->map = mmap(NULL, snapshot->map_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (snapshot->map == MAP_FAILED)
+    {
+        free(snapshot);
+        return NULL;
+    }
+
+    snapshot->header = (const SnapshotHeader *)snapshot->map;
+    if (!snapshot_valid(snapshot))
+    {
+        free_snapshot(snapshot);
+        return NULL;
+    }
+    snapshot->records =
+        snapshot->header->element_size
+            ? NULL
+            : (const SnapshotRecord *)(snapshot->map
+                                       + snapshot->header->table_offset);
+    return snapshot;
+}
+
+/**
+ * @brief Load a snapshot file by memory-mapping it.
+ *
+ * The file is mapped in one call and the returned list points straight into
+ * the mapping: no payload is copied or allocated, and all the nodes are
+ * allocated in a single block. The list does not own its payloads. It must
+ * be freed before the snapshot, which is released with free_snapshot.
+ * Payloads may be modified in place; changes stay private to the process.
+ *
+ * @param[in] path Path of a file written by list_save or list_save_inline.
+ * @param[out] snapshot Receives the handle of the mapping.
+ * @return A new linked list over the mapped payloads, or NULL if the file
+ * cannot be mapped, is not a valid snapshot, or memory allocation fails.
+ */
+LinkedList *list_load_mmap(const char *path, ListSnapshot **snapshot)
+{
+    if (!path || !snapshot)
+        return NULL;
+
+    ListSnapshot *mapped = map_snapshot(path);
+    if (!mapped)
+        return NULL;
+
+    LinkedList *list = init_linked_list(NULL);
+    size_t count = (size_t)mapped->header->count;
+    Node *nodes = count ? create_node_block(count) : NULL;
+    if (!list || (count && !nodes))
+    {
+        free(list);
+        free_snapshot(mapped);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++)
+        nodes[i].data = (void *)snapshot_get(mapped, i, NULL);
+    list->head = nodes;
+    list->size = count;
+    *snapshot = mapped;
+    return list;
+}
+
+/**
+ * @brief Get the number of elements stored in a snapshot.
+ *
+ * @param[in] snapshot Handle returned by list_load_mmap.
+ * @return The number of elements in the snapshot.
+ */
+size_t snapshot_length(ListSnapshot *snapshot)
+{
+    return snapshot ? (size_t)snapshot->header->count : 0;
+}
+
+/**
+ * @brief Get an element of a snapshot by position, without building a list.
+ *
+ * @param[in] snapshot Handle returned by list_load_mmap.
+ * @param[in] position The position of the element (0-based index).
+ * @param[out] size Receives the size of the element in bytes, may be NULL.
+ * @return Pointer to the element inside the mapping, or NULL if out of
+ * bounds.
+ */
+const void *snapshot_get(ListSnapshot *snapshot, size_t position,
+                         size_t *size)
+{
+    if (!snapshot || position >= snapshot->header->count)
+        return NULL;
+
+    const SnapshotHeader *header = snapshot->header;
+    const unsigned char *data = snapshot->map + header->data_offset;
+    if (header->element_size)
+    {
+        if (size)
+            *size = (size_t)header->element_size;
+        return data + position * header->element_size;
+    }
+    if (size)
+        *size = (size_t)snapshot->records[position].size;
+    return data + snapshot->records[position].offset;
+}
+
+/**
+ * @brief Unmap a snapshot.
+ *
+ * Lists returned by list_load_mmap for this snapshot must be freed first.
+ *
+ * @param[in] snapshot Handle returned by list_load_mmap.
+ */
+void free_snapshot(ListSnapshot *snapshot)
+{
+    if (!snapshot)
+        return;
+    munmap(snapshot->map, snapshot->map_size);
+    free(snapshot);
+}
@@ -1,13 +1,7 @@
 #include <stdlib.h>
 
-#include "node.h"
-
-struct Stack
-{
-    struct Node *head;
-    size_t size;
-    void (*free_data)(void *data);
-};
+#include "memory.h"
+#include "stack.h"
 
 /**
  * @brief Initializes a new stack.
@@ -28,6 +22,7 @@ Stack *init_stack(void (*free_data)(void *data))
     stack->head = NULL;
     stack->size = 0;
     stack->free_data = free_data;
+    stack->memory_entry = NULL;
     return stack;
 }
 
@@ -42,12 +37,10 @@ void push(Stack *stack, void *data)
     if (!stack)
         return;
 
-    Node *new_node = (Node *)malloc(sizeof(Node));
+    Node *new_node = create_node(data, stack->head);
     if (!new_node)
         return;
 
-    new_node->data = data;
-    new_node->next = stack->head;
     stack->head = new_node;
     stack->size++;
 }
@@ -68,7 +61,7 @@ void *pop(Stack *stack)
     Node *top_node = stack->head;
     void *data = top_node->data;
     stack->head = top_node->next;
-    free(top_node);
+    free_node(top_node);
     stack->size--;
     return data;
 }
@@ -95,6 +88,117 @@ size_t length(Stack *stack)
     return stack ? stack->size : 0;
 }
 
+/**
+ * @brief Creates a stack from an array of data pointers.
+ *
+ * The result is the same as pushing the items in array order, so the last
+ * item ends up on top, but all the nodes are allocated in a single block and
+ * chained in one linear pass.
+ *
+ * @param items Array of data pointers to push, from bottom to top.
+ * @param count Number of entries in `items`.
+ * @param free_data A function pointer for freeing the data of each node, or
+ * NULL.
+ * @return Stack* A pointer to the newly created stack, or NULL if memory
+ * allocation fails.
+ */
+Stack *stack_from_array(void **items, size_t count,
+                        void (*free_data)(void *data))
+{
+    Stack *stack = init_stack(free_data);
+    if (!stack || count == 0)
+        return stack;
+
+    Node *nodes = create_node_block(count);
+    if (!nodes)
+    {
+        free(stack);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++)
+        nodes[i].data = items[count - 1 - i];
+    stack->head = nodes;
+    stack->size = count;
+    return stack;
+}
+
+/**
+ * @brief Copies the data pointers of the stack into an array.
+ *
+ * The pointers are written from bottom to top, so that stack_from_array on
+ * the result rebuilds the same stack. The data itself is not copied.
+ *
+ * @param stack The stack to read.
+ * @param out Array receiving the data pointers. It must have room for
+ * length(stack) entries.
+ * @return size_t The number of pointers written to `out`.
+ */
+size_t stack_to_array(Stack *stack, void **out)
+{
+    if (!stack || !out)
+        return 0;
+
+    size_t index = stack->size;
+    for (Node *current = stack->head; current; current = current->next)
+        out[--index] = current->data;
+    return stack->size;
+}
+
+/**
+ * @brief Estimates the memory used by the stack.
+ *
+ * The nodes and the allocator overhead of the stack and of its nodes are
+ * accounted for. Payloads are measured with `payload_size`, without
+ * allocator overhead since the stack does not allocate them. If the stack is
+ * tracked by the memory usage registry, the registry is updated with the
+ * result.
+ *
+ * @param stack The stack to measure.
+ * @param payload_size A function returning the size of an element, or NULL to
+ * leave payloads out.
+ * @return MemoryUsage The estimated memory usage, all zero if `stack` is NULL.
+ */
+MemoryUsage stack_memory_usage(Stack *stack,
+                               size_t (*payload_size)(const void *data))
+{
+    MemoryUsage usage = {0};
+    if (!stack)
+        return usage;
+
+    usage = chain_memory_usage(stack->head, allocation_footprint(sizeof(Stack)),
+                               payload_size);
+    memory_registry_update(stack->memory_entry, &usage);
+    return usage;
+}
+
+/**
+ * @brief Tracks the memory used by the stack in the process registry.
+ *
+ * The stack is measured right away, then again on every call to
+ * stack_memory_usage, until it is freed. Tracking a stack again renames it.
+ *
+ * @param stack The stack to track.
+ * @param name The name under which the stack is exported.
+ * @param payload_size A function returning the size of an element, or NULL to
+ * leave payloads out.
+ * @return int 0 on success, or -1 if memory allocation fails.
+ */
+int stack_track_memory(Stack *stack, const char *name,
+                       size_t (*payload_size)(const void *data))
+{
+    if (!stack)
+        return -1;
+
+    MemoryEntry *entry = memory_registry_add(name);
+    if (!entry)
+        return -1;
+    memory_registry_remove(stack->memory_entry);
+    stack->memory_entry = entry;
+    stack_memory_usage(stack, payload_size);
+    return 0;
+}
+
 /**
  * @brief Frees all elements in the stack and the stack itself.
  *
@@ -106,16 +210,7 @@ void free_stack(Stack *stack)
     if (!stack)
         return;
 
-    Node *current = stack->head;
-    while (current)
-    {
-        Node *next = current->next;
-        if (stack->free_data)
-        {
-            stack->free_data(current->data);
-        }
-        free(current);
-        current = next;
-    }
+    free_chain(stack->head, stack->free_data);
+    memory_registry_remove(stack->memory_entry);
     free(stack);
 }
@@ -0,0 +1,16 @@
+#ifndef STACK_H
+#define STACK_H
+
+#include <stddef.h>
+
+#include "node.h"
+
+struct Stack
+{
+    struct Node *head;
+    size_t size;
+    void (*free_data)(void *data);
+    struct MemoryEntry *memory_entry;
+};
+
+#endif
@@ -1,11 +1,20 @@
 #include <stdio.h>
 
+#include "test_concurrent_list.h"
+#include "test_external_sort.h"
+#include "test_ingest.h"
+#include "test_intrusive.h"
 #include "test_linked_list.h"
+#include "test_memory.h"
+#include "test_numeric.h"
+#include "test_pqueue.h"
+#include "test_reclaimer.h"
+#include "test_snapshot.h"
 #include "test_stack.h"
 
 int main()
 {
-    int total_tests = 9;
+    int total_tests = 32;
     int passed_tests = 0;
 
     printf("\nRunning tests for linked list...\n");
@@ -18,9 +27,32 @@ int main()
     passed_tests += test_map();
     passed_tests += test_filter();
     passed_tests += test_sort();
+    passed_tests += test_top_k();
+    passed_tests += test_partial_sort();
+    passed_tests += test_sort_presorted();
+    passed_tests += test_sort_reversed();
+    passed_tests += test_sort_runs();
+    passed_tests += test_insert_sorted();
+    passed_tests += test_merge_sorted();
+    passed_tests += test_kway_merge();
+    passed_tests += test_find_sorted();
+    passed_tests += test_list_array_conversion();
+    passed_tests += test_reduce();
+    passed_tests += test_parallel_reduce();
+    passed_tests += test_foreach_prefetch();
+    passed_tests += test_list_compact();
+    passed_tests += test_auto_compact();
+    passed_tests += test_list_clone_cow();
+    passed_tests += test_clone_cow_release();
+    passed_tests += test_clone_cow_ownership();
+    passed_tests += test_hash_index();
+    passed_tests += test_hash_index_sync();
+    passed_tests += test_partition();
+    passed_tests += test_group_by();
+    passed_tests += test_group_by_parallel();
     printf("\n%d/%d tests passed.\n", passed_tests, total_tests);
 
-    total_tests = 6;
+    total_tests = 7;
     passed_tests = 0;
     printf("\nRunning tests for stack...\n");
     passed_tests += test_stack_initialization();
@@ -29,6 +61,85 @@ int main()
     passed_tests += test_pop_empty_stack();
     passed_tests += test_is_empty();
     passed_tests += test_stack_length();
+    passed_tests += test_stack_array_conversion();
+    printf("\n%d/%d tests passed.\n", passed_tests, total_tests);
+
+    total_tests = 3;
+    passed_tests = 0;
+    printf("\nRunning tests for intrusive containers...\n");
+    passed_tests += test_intrusive_list();
+    passed_tests += test_intrusive_sort();
+    passed_tests += test_intrusive_stack();
+    printf("\n%d/%d tests passed.\n", passed_tests, total_tests);
+
+    total_tests = 4;
+    passed_tests = 0;
+    printf("\nRunning tests for priority queue...\n");
+    passed_tests += test_pqueue_push_pop();
+    passed_tests += test_pqueue_push_n();
+    passed_tests += test_pqueue_decrease_key();
+    passed_tests += test_free_pqueue();
+    printf("\n%d/%d tests passed.\n", passed_tests, total_tests);
+
+    total_tests = 4;
+    passed_tests = 0;
+    printf("\nRunning tests for concurrent list...\n");
+    passed_tests += test_concurrent_list_initialization();
+    passed_tests += test_concurrent_insert_remove();
+    passed_tests += test_concurrent_parallel_appends();
+    passed_tests += test_concurrent_parallel_updates();
+    printf("\n%d/%d tests passed.\n", passed_tests, total_tests);
+
+    total_tests = 3;
+    passed_tests = 0;
+    printf("\nRunning tests for snapshots...\n");
+    passed_tests += test_snapshot_variable_records();
+    passed_tests += test_snapshot_inline_records();
+    passed_tests += test_snapshot_invalid_file();
+    printf("\n%d/%d tests passed.\n", passed_tests, total_tests);
+
+    total_tests = 5;
+    passed_tests = 0;
+    printf("\nRunning tests for external sort...\n");
+    passed_tests += test_external_sort_in_memory();
+    passed_tests += test_external_sort_spilled_runs();
+    passed_tests += test_external_sort_stream();
+    passed_tests += test_external_sort_many_runs();
+    passed_tests += test_external_sort_failure();
+    printf("\n%d/%d tests passed.\n", passed_tests, total_tests);
+
+    total_tests = 3;
+    passed_tests = 0;
+    printf("\nRunning tests for ingestion...\n");
+    passed_tests += test_ingest_fd();
+    passed_tests += test_ingest_long_lines();
+    passed_tests += test_ingest_mmap();
+    printf("\n%d/%d tests passed.\n", passed_tests, total_tests);
+
+    total_tests = 4;
+    passed_tests = 0;
+    printf("\nRunning tests for numeric array...\n");
+    passed_tests += test_numeric_from_list();
+    passed_tests += test_numeric_aggregates();
+    passed_tests += test_numeric_count_and_filter();
+    passed_tests += test_numeric_map_affine();
+    printf("\n%d/%d tests passed.\n", passed_tests, total_tests);
+
+    total_tests = 3;
+    passed_tests = 0;
+    printf("\nRunning tests for memory usage...\n");
+    passed_tests += test_list_memory_usage();
+    passed_tests += test_stack_memory_usage();
+    passed_tests += test_memory_registry();
+    printf("\n%d/%d tests passed.\n", passed_tests, total_tests);
+
+    total_tests = 4;
+    passed_tests = 0;
+    printf("\nRunning tests for background reclamation...\n");
+    passed_tests += test_free_linked_list_async();
+    passed_tests += test_free_stack_async();
+    passed_tests += test_reclaimer_backpressure();
+    passed_tests += test_reclaimer_nested_free();
     printf("\n%d/%d tests passed.\n", passed_tests, total_tests);
 
     return 0;
@@ -0,0 +1,174 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/utils.h"
+
+#define THREADS 4
+#define OPERATIONS 500
+
+static void free_int(void *data)
+{
+    free(data);
+}
+
+static void print_test_result(const char *test_name, int passed)
+{
+    if (passed)
+    {
+        printf("[SUCCESS] %s\n", test_name);
+    }
+    else
+    {
+        printf("[FAILURE] %s\n", test_name);
+    }
+}
+
+static int *new_int(int value)
+{
+    int *num = malloc(sizeof(int));
+    *num = value;
+    return num;
+}
+
+static int clist_matches(ConcurrentList *list, const int *values, size_t count)
+{
+    if (clist_length(list) != count)
+        return 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        int *data = clist_get_at(list, i);
+        if (!data || *data != values[i])
+            return 0;
+    }
+    return clist_get_at(list, count) == NULL;
+}
+
+static _Thread_local long long sum;
+
+static void add_to_sum(void *data)
+{
+    sum += *(int *)data;
+}
+
+static void *append_worker(void *arg)
+{
+    ConcurrentList *list = arg;
+    for (int i = 1; i <= OPERATIONS; i++)
+        clist_append(list, new_int(i));
+    return NULL;
+}
+
+static void *update_worker(void *arg)
+{
+    ConcurrentList *list = arg;
+    for (int i = 0; i < OPERATIONS; i++)
+    {
+        clist_insert_at(list, new_int(1), i % 7);
+        clist_remove_at(list, (size_t)i % 5);
+        clist_get_at(list, (size_t)i % 11);
+    }
+    return NULL;
+}
+
+int test_concurrent_list_initialization()
+{
+    ConcurrentList *list =
+        init_concurrent_list(CONCURRENT_LIST_LOCK_COUPLING, free_int);
+    int passed = list != NULL && clist_length(list) == 0
+        && clist_get_at(list, 0) == NULL;
+    free_concurrent_list(list);
+    print_test_result("test_concurrent_list_initialization", passed);
+    return passed;
+}
+
+int test_concurrent_insert_remove()
+{
+    int passed = 1;
+    ConcurrentListMode modes[] = {CONCURRENT_LIST_RWLOCK,
+                                  CONCURRENT_LIST_LOCK_COUPLING};
+
+    for (int m = 0; m < 2; m++)
+    {
+        ConcurrentList *list = init_concurrent_list(modes[m], free_int);
+        clist_append(list, new_int(10));
+        clist_append(list, new_int(30));
+        clist_insert_at(list, new_int(20), 1);
+        clist_insert_at(list, new_int(0), 0);
+        clist_insert_at(list, new_int(40), 100);
+        int expected[] = {0, 10, 20, 30, 40};
+        passed = passed && clist_matches(list, expected, 5);
+
+        clist_remove_at(list, 0);
+        clist_remove_at(list, 2);
+        clist_remove_at(list, 10);
+        int remaining[] = {10, 20, 40};
+        passed = passed && clist_matches(list, remaining, 3);
+
+        sum = 0;
+        clist_foreach(list, add_to_sum);
+        passed = passed && sum == 70;
+
+        free_concurrent_list(list);
+    }
+
+    print_test_result("test_concurrent_insert_remove", passed);
+    return passed;
+}
+
+int test_concurrent_parallel_appends()
+{
+    int passed = 1;
+    ConcurrentListMode modes[] = {CONCURRENT_LIST_RWLOCK,
+                                  CONCURRENT_LIST_LOCK_COUPLING};
+
+    for (int m = 0; m < 2; m++)
+    {
+        ConcurrentList *list = init_concurrent_list(modes[m], free_int);
+        pthread_t threads[THREADS];
+        for (int t = 0; t < THREADS; t++)
+            pthread_create(&threads[t], NULL, append_worker, list);
+        for (int t = 0; t < THREADS; t++)
+            pthread_join(threads[t], NULL);
+
+        sum = 0;
+        clist_foreach(list, add_to_sum);
+        passed = passed && clist_length(list) == THREADS * OPERATIONS
+            && sum == (long long)THREADS * OPERATIONS * (OPERATIONS + 1) / 2;
+
+        free_concurrent_list(list);
+    }
+
+    print_test_result("test_concurrent_parallel_appends", passed);
+    return passed;
+}
+
+int test_concurrent_parallel_updates()
+{
+    int passed = 1;
+    ConcurrentListMode modes[] = {CONCURRENT_LIST_RWLOCK,
+                                  CONCURRENT_LIST_LOCK_COUPLING};
+
+    for (int m = 0; m < 2; m++)
+    {
+        ConcurrentList *list = init_concurrent_list(modes[m], free_int);
+        for (int i = 0; i < 100; i++)
+            clist_append(list, new_int(1));
+
+        pthread_t threads[THREADS];
+        for (int t = 0; t < THREADS; t++)
+            pthread_create(&threads[t], NULL, update_worker, list);
+        for (int t = 0; t < THREADS; t++)
+            pthread_join(threads[t], NULL);
+
+        // Every thread inserted and removed as many elements as it added
+        sum = 0;
+        clist_foreach(list, add_to_sum);
+        passed = passed && clist_length(list) == 100 && sum == 100;
+
+        free_concurrent_list(list);
+    }
+
+    print_test_result("test_concurrent_parallel_updates", passed);
+    return passed;
+}
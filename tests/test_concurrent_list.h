@@ -0,0 +1,9 @@
+#ifndef TEST_CONCURRENT_LIST_H
+#define TEST_CONCURRENT_LIST_H
+
+int test_concurrent_list_initialization();
+int test_concurrent_insert_remove();
+int test_concurrent_parallel_appends();
+int test_concurrent_parallel_updates();
+
+#endif /* TEST_CONCURRENT_LIST_H */
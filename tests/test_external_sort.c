@@ -0,0 +1,246 @@
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#include "../include/utils.h"
+
+// Records sorted by key; seq keeps the insertion order to check stability
+typedef struct Record
+{
+    int key;
+    int seq;
+} Record;
+
+static void free_record(void *data)
+{
+    free(data);
+}
+
+static void print_test_result(const char *test_name, int passed)
+{
+    if (passed)
+    {
+        printf("[SUCCESS] %s\n", test_name);
+    }
+    else
+    {
+        printf("[FAILURE] %s\n", test_name);
+    }
+}
+
+static int compare_records(const void *a, const void *b)
+{
+    return ((const Record *)a)->key - ((const Record *)b)->key;
+}
+
+static size_t serialize_record(const void *data, void *buffer,
+                               size_t capacity)
+{
+    if (capacity >= sizeof(Record))
+        memcpy(buffer, data, sizeof(Record));
+    return sizeof(Record);
+}
+
+// Sequence number of a record serialized past the file size limit set by
+// test_external_sort_failure, making the spill of its chunk fail, or -1
+static int failing_seq = -1;
+#define FAILING_SIZE (1 << 17)
+
+static size_t serialize_or_fail(const void *data, void *buffer,
+                                size_t capacity)
+{
+    if (((const Record *)data)->seq != failing_seq)
+        return serialize_record(data, buffer, capacity);
+    if (capacity >= FAILING_SIZE)
+        memset(buffer, 0, FAILING_SIZE);
+    return FAILING_SIZE;
+}
+
+static void *deserialize_record(const void *buffer, size_t size)
+{
+    Record *record = malloc(sizeof(Record));
+    memcpy(record, buffer, size);
+    return record;
+}
+
+static LinkedList *make_record_list(int count)
+{
+    LinkedList *list = init_linked_list(free_record);
+    unsigned int seed = 7;
+    for (int i = 0; i < count; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        Record *record = malloc(sizeof(Record));
+        record->key = (seed >> 16) % 50;
+        record->seq = i;
+        append(list, record);
+    }
+    return list;
+}
+
+static int records_sorted(Record **records, size_t count)
+{
+    for (size_t i = 1; i < count; i++)
+    {
+        int order = compare_records(records[i - 1], records[i]);
+        if (order > 0 || (order == 0 && records[i - 1]->seq > records[i]->seq))
+            return 0;
+    }
+    return 1;
+}
+
+static int list_sorted(LinkedList *list)
+{
+    size_t count = list_length(list);
+    Record **records = malloc((count ? count : 1) * sizeof(Record *));
+    list_to_array(list, (void **)records);
+    int sorted = records_sorted(records, count);
+    free(records);
+    return sorted;
+}
+
+typedef struct Collected
+{
+    Record *records[500];
+    size_t count;
+} Collected;
+
+static void collect_record(void *data, void *context)
+{
+    Collected *collected = context;
+    collected->records[collected->count++] = data;
+}
+
+int test_external_sort_in_memory()
+{
+    LinkedList *list = make_record_list(300);
+    void *first = get_at(list, 0);
+
+    // The list is sorted in place, keeping its payloads
+    int status = external_sort(list, compare_records, serialize_record,
+                               deserialize_record, 1 << 20, NULL);
+    int passed = status == 0 && list_length(list) == 300 && list_sorted(list)
+        && list_contains(list, first);
+
+    free_linked_list(list);
+    print_test_result("test_external_sort_in_memory", passed);
+    return passed;
+}
+
+int test_external_sort_spilled_runs()
+{
+    // Three records per run gives more runs than a single merge pass takes
+    LinkedList *list = make_record_list(500);
+
+    int status =
+        external_sort(list, compare_records, serialize_record,
+                      deserialize_record, 3 * sizeof(Record), "/tmp");
+    int passed = status == 0 && list_length(list) == 500 && list_sorted(list);
+
+    free_linked_list(list);
+    print_test_result("test_external_sort_spilled_runs", passed);
+    return passed;
+}
+
+int test_external_sort_stream()
+{
+    LinkedList *list = make_record_list(500);
+    Collected collected = {.count = 0};
+
+    int status = external_sort_stream(
+        list, compare_records, serialize_record, deserialize_record,
+        64 * sizeof(Record), NULL, collect_record, &collected);
+    int passed = status == 0 && list_length(list) == 0
+        && collected.count == 500
+        && records_sorted(collected.records, collected.count);
+
+    for (size_t i = 0; i < collected.count; i++)
+        free(collected.records[i]);
+    free_linked_list(list);
+    print_test_result("test_external_sort_stream", passed);
+    return passed;
+}
+
+int test_external_sort_many_runs()
+{
+    // One record per run, with fewer descriptors available than runs
+    struct rlimit saved;
+    getrlimit(RLIMIT_NOFILE, &saved);
+    struct rlimit limited = saved;
+    if (limited.rlim_cur > 128)
+        limited.rlim_cur = 128;
+    setrlimit(RLIMIT_NOFILE, &limited);
+
+    LinkedList *list = make_record_list(1000);
+    int status = external_sort(list, compare_records, serialize_record,
+                               deserialize_record, sizeof(Record), NULL);
+    setrlimit(RLIMIT_NOFILE, &saved);
+    int passed =
+        status == 0 && list_length(list) == 1000 && list_sorted(list);
+
+    free_linked_list(list);
+    print_test_result("test_external_sort_many_runs", passed);
+    return passed;
+}
+
+// Whether the list holds each sequence number below count exactly once
+static int holds_every_record(LinkedList *list, int count)
+{
+    if (list_length(list) != (size_t)count)
+        return 0;
+    char *seen = calloc(count, 1);
+    Record **records = malloc(count * sizeof(Record *));
+    list_to_array(list, (void **)records);
+    int passed = 1;
+    for (int i = 0; i < count && passed; i++)
+    {
+        passed = records[i]->seq >= 0 && records[i]->seq < count
+            && !seen[records[i]->seq];
+        if (passed)
+            seen[records[i]->seq] = 1;
+    }
+    free(records);
+    free(seen);
+    return passed;
+}
+
+int test_external_sort_failure()
+{
+    // No run can be created: the list keeps its elements
+    LinkedList *list = make_record_list(500);
+    int status = external_sort(list, compare_records, serialize_record,
+                               deserialize_record, 3 * sizeof(Record),
+                               "/nonexistent/libutils");
+    int passed = status == -1 && holds_every_record(list, 500);
+    free_linked_list(list);
+
+    // Writing a chunk fails after others were spilled: they are read back
+    struct rlimit saved;
+    getrlimit(RLIMIT_FSIZE, &saved);
+    struct rlimit limited = saved;
+    limited.rlim_cur = FAILING_SIZE / 2;
+    setrlimit(RLIMIT_FSIZE, &limited);
+    void (*handler)(int) = signal(SIGXFSZ, SIG_IGN);
+
+    list = make_record_list(500);
+    failing_seq = 250;
+    status = external_sort(list, compare_records, serialize_or_fail,
+                           deserialize_record, 8 * sizeof(Record), NULL);
+    failing_seq = -1;
+    signal(SIGXFSZ, handler);
+    setrlimit(RLIMIT_FSIZE, &saved);
+    passed = passed && status == -1 && holds_every_record(list, 500);
+
+    // The list is still usable afterwards
+    passed = passed
+        && external_sort(list, compare_records, serialize_record,
+                         deserialize_record, 8 * sizeof(Record), NULL)
+               == 0
+        && list_length(list) == 500 && list_sorted(list);
+    free_linked_list(list);
+
+    print_test_result("test_external_sort_failure", passed);
+    return passed;
+}
@@ -0,0 +1,10 @@
+#ifndef TEST_EXTERNAL_SORT_H
+#define TEST_EXTERNAL_SORT_H
+
+int test_external_sort_in_memory();
+int test_external_sort_spilled_runs();
+int test_external_sort_stream();
+int test_external_sort_many_runs();
+int test_external_sort_failure();
+
+#endif /* TEST_EXTERNAL_SORT_H */
@@ -0,0 +1,180 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../include/utils.h"
+
+static void print_test_result(const char *test_name, int passed)
+{
+    if (passed)
+    {
+        printf("[SUCCESS] %s\n", test_name);
+    }
+    else
+    {
+        printf("[FAILURE] %s\n", test_name);
+    }
+}
+
+static void free_data(void *data)
+{
+    free(data);
+}
+
+// Copy the line into a string
+static void *parse_string(const char *line, size_t length, void *context)
+{
+    (void)context;
+    return strndup(line, length);
+}
+
+// Parse the line as an integer, counting the calls in the context. Empty
+// lines and comments are skipped.
+static void *parse_int(const char *line, size_t length, void *context)
+{
+    (*(int *)context)++;
+    char digits[32];
+    if (length == 0 || length >= sizeof(digits) || line[0] == '#')
+        return NULL;
+    memcpy(digits, line, length);
+    digits[length] = '\0';
+    int *num = malloc(sizeof(int));
+    *num = atoi(digits);
+    return num;
+}
+
+// Create a temporary file holding `contents` and return its path in `path`
+static void temporary_file(char *path, const char *contents, size_t length)
+{
+    strcpy(path, "/tmp/libutils_ingest_XXXXXX");
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return;
+    if (write(fd, contents, length) != (ssize_t)length)
+        path[0] = '\0';
+    close(fd);
+}
+
+int test_ingest_fd()
+{
+    // The last line has no newline, and the comment and empty line are
+    // skipped by the parser
+    const char contents[] = "10\n20\n\n# comment\n30\n40";
+    char path[64];
+    temporary_file(path, contents, strlen(contents));
+
+    LinkedList *list = init_linked_list(free_data);
+    int *first = malloc(sizeof(int));
+    *first = 0;
+    append(list, first);
+
+    int calls = 0;
+    int fd = open(path, O_RDONLY);
+    ssize_t added = list_ingest_fd(list, fd, parse_int, &calls);
+    close(fd);
+
+    int expected[] = {0, 10, 20, 30, 40};
+    int passed = added == 4 && calls == 6 && list_length(list) == 5;
+    for (int i = 0; passed && i < 5; i++)
+        passed = *(int *)get_at(list, i) == expected[i];
+
+    // Appending after the ingested elements still works
+    int *last = malloc(sizeof(int));
+    *last = 50;
+    append(list, last);
+    passed = passed && list_length(list) == 6 && *(int *)get_at(list, 5) == 50;
+
+    // An unreadable descriptor leaves the list unchanged
+    passed = passed && list_ingest_fd(list, -1, parse_int, &calls) == -1
+        && list_length(list) == 6;
+
+    free_linked_list(list);
+    unlink(path);
+    print_test_result("test_ingest_fd", passed);
+    return passed;
+}
+
+int test_ingest_long_lines()
+{
+    // A line longer than a read chunk, between two short ones, forces the
+    // read buffer to grow
+    size_t long_length = 3 << 20;
+    size_t length = long_length + 8;
+    char *contents = malloc(length);
+    memcpy(contents, "abc\n", 4);
+    memset(contents + 4, 'x', long_length);
+    memcpy(contents + 4 + long_length, "\nxyz", 4);
+
+    char path[64];
+    temporary_file(path, contents, length);
+
+    LinkedList *list = init_linked_list(free_data);
+    int fd = open(path, O_RDONLY);
+    ssize_t added = list_ingest_fd(list, fd, parse_string, NULL);
+    close(fd);
+
+    int passed = added == 3 && list_length(list) == 3
+        && strcmp(get_at(list, 0), "abc") == 0
+        && strlen(get_at(list, 1)) == long_length
+        && memcmp(get_at(list, 1), contents + 4, long_length) == 0
+        && strcmp(get_at(list, 2), "xyz") == 0;
+
+    free_linked_list(list);
+    free(contents);
+    unlink(path);
+    print_test_result("test_ingest_long_lines", passed);
+    return passed;
+}
+
+int test_ingest_mmap()
+{
+    // Enough lines to fill several node blocks
+    size_t length = 0;
+    char *contents = malloc(10000 * 8);
+    for (int i = 0; i < 10000; i++)
+        length += sprintf(contents + length, "%d\n", i);
+
+    char path[64];
+    temporary_file(path, contents, length);
+
+    int calls = 0;
+    LinkedList *mapped = init_linked_list(free_data);
+    ssize_t added = list_ingest_mmap(mapped, path, parse_int, &calls);
+
+    LinkedList *read = init_linked_list(free_data);
+    int fd = open(path, O_RDONLY);
+    ssize_t read_added = list_ingest_fd(read, fd, parse_int, &calls);
+    close(fd);
+
+    int passed = added == 10000 && read_added == 10000 && calls == 20000
+        && list_length(mapped) == 10000 && list_length(read) == 10000;
+    void **mapped_items = malloc(10000 * sizeof(void *));
+    void **read_items = malloc(10000 * sizeof(void *));
+    passed = passed && list_to_array(mapped, mapped_items) == 10000
+        && list_to_array(read, read_items) == 10000;
+    for (int i = 0; passed && i < 10000; i++)
+        passed = *(int *)mapped_items[i] == i && *(int *)read_items[i] == i;
+    free(mapped_items);
+    free(read_items);
+
+    // Missing and empty files
+    passed = passed
+        && list_ingest_mmap(mapped, "/nonexistent/libutils", parse_int, &calls)
+               == -1
+        && list_length(mapped) == 10000;
+    char empty_path[64];
+    temporary_file(empty_path, "", 0);
+    passed = passed
+        && list_ingest_mmap(mapped, empty_path, parse_int, &calls) == 0
+        && list_length(mapped) == 10000;
+
+    free_linked_list(mapped);
+    free_linked_list(read);
+    free(contents);
+    unlink(path);
+    unlink(empty_path);
+    print_test_result("test_ingest_mmap", passed);
+    return passed;
+}
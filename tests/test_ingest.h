@@ -0,0 +1,8 @@
+#ifndef TEST_INGEST_H
+#define TEST_INGEST_H
+
+int test_ingest_fd();
+int test_ingest_long_lines();
+int test_ingest_mmap();
+
+#endif /* TEST_INGEST_H */
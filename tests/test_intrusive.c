@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/utils.h"
+
+typedef struct Item
+{
+    int key;
+    int order;
+    ListLink link;
+} Item;
+
+static int freed_count = 0;
+
+static void free_item(ListLink *link)
+{
+    free(container_of(link, Item, link));
+    freed_count++;
+}
+
+static void print_test_result(const char *test_name, int passed)
+{
+    if (passed)
+    {
+        printf("[SUCCESS] %s\n", test_name);
+    }
+    else
+    {
+        printf("[FAILURE] %s\n", test_name);
+    }
+}
+
+static Item *new_item(int key, int order)
+{
+    Item *item = malloc(sizeof(Item));
+    item->key = key;
+    item->order = order;
+    return item;
+}
+
+static int key_at(IntrusiveList *list, size_t position)
+{
+    ListLink *link = list_link_get_at(list, position);
+    return link ? container_of(link, Item, link)->key : -1;
+}
+
+static int compare_items(const void *a, const void *b)
+{
+    int x = container_of(a, Item, link)->key;
+    int y = container_of(b, Item, link)->key;
+    return (x > y) - (x < y);
+}
+
+static int key_sum = 0;
+
+static void add_key(ListLink *link)
+{
+    key_sum += container_of(link, Item, link)->key;
+}
+
+int test_intrusive_list()
+{
+    IntrusiveList list;
+    init_intrusive_list(&list);
+
+    for (int i = 1; i <= 4; i++)
+        list_link_append(&list, &new_item(i * 10, 0)->link);
+    list_link_insert_at(&list, &new_item(5, 0)->link, 0);
+    list_link_insert_at(&list, &new_item(25, 0)->link, 3);
+    list_link_insert_at(&list, &new_item(99, 0)->link, 100);
+
+    int expected[] = {5, 10, 20, 25, 30, 40, 99};
+    int passed = list_link_length(&list) == 7;
+    for (size_t i = 0; i < 7; i++)
+        passed = passed && key_at(&list, i) == expected[i];
+
+    // Removing the tail keeps appends in the right place
+    ListLink *removed = list_link_remove_at(&list, 6);
+    passed = passed && removed && container_of(removed, Item, link)->key == 99
+        && list_link_remove_at(&list, 6) == NULL;
+    free_item(removed);
+    list_link_append(&list, &new_item(50, 0)->link);
+    passed = passed && key_at(&list, 6) == 50;
+
+    key_sum = 0;
+    list_link_foreach(&list, add_key);
+    passed = passed && key_sum == 5 + 10 + 20 + 25 + 30 + 40 + 50;
+
+    freed_count = 0;
+    free_intrusive_list(&list, free_item);
+    passed = passed && freed_count == 7 && list_link_length(&list) == 0
+        && list.head == NULL && list.tail == NULL;
+
+    print_test_result("test_intrusive_list", passed);
+    return passed;
+}
+
+int test_intrusive_sort()
+{
+    IntrusiveList list;
+    init_intrusive_list(&list);
+
+    int keys[] = {3, 1, 2, 3, 1, 2, 0, 5, 4, 4};
+    for (int i = 0; i < 10; i++)
+        list_link_append(&list, &new_item(keys[i], i)->link);
+    for (int i = 0; i < 100; i++)
+        list_link_append(&list, &new_item(100 - i, 10 + i)->link);
+    list_link_sort(&list, compare_items);
+
+    int passed = list_link_length(&list) == 110;
+    Item *previous = NULL;
+    for (ListLink *link = list.head; link; link = link->next)
+    {
+        Item *item = container_of(link, Item, link);
+        if (previous)
+            passed = passed
+                && (previous->key < item->key
+                    || (previous->key == item->key
+                        && previous->order < item->order));
+        previous = item;
+    }
+
+    // The tail follows the sort
+    passed = passed && list.tail == &previous->link && previous->key == 100;
+    list_link_append(&list, &new_item(101, 110)->link);
+    passed = passed && key_at(&list, 110) == 101;
+
+    free_intrusive_list(&list, free_item);
+    print_test_result("test_intrusive_sort", passed);
+    return passed;
+}
+
+int test_intrusive_stack()
+{
+    IntrusiveStack stack;
+    init_intrusive_stack(&stack);
+
+    int passed = stack_link_pop(&stack) == NULL
+        && stack_link_peek(&stack) == NULL;
+    for (int i = 0; i < 5; i++)
+        stack_link_push(&stack, &new_item(i, 0)->link);
+    passed = passed && stack_link_length(&stack) == 5
+        && container_of(stack_link_peek(&stack), Item, link)->key == 4;
+
+    ListLink *top = stack_link_pop(&stack);
+    passed = passed && container_of(top, Item, link)->key == 4
+        && stack_link_length(&stack) == 4;
+    free_item(top);
+
+    key_sum = 0;
+    stack_link_foreach(&stack, add_key);
+    passed = passed && key_sum == 0 + 1 + 2 + 3;
+
+    freed_count = 0;
+    free_intrusive_stack(&stack, free_item);
+    passed = passed && freed_count == 4 && stack_link_length(&stack) == 0;
+
+    print_test_result("test_intrusive_stack", passed);
+    return passed;
+}
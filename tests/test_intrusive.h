@@ -0,0 +1,8 @@
+#ifndef TEST_INTRUSIVE_H
+#define TEST_INTRUSIVE_H
+
+int test_intrusive_list();
+int test_intrusive_sort();
+int test_intrusive_stack();
+
+#endif /* TEST_INTRUSIVE_H */
@@ -1,16 +1,10 @@
 #include <assert.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include "../include/utils.h"
-#include "../src/node.h"
-
-struct LinkedList
-{
-    struct Node *head;
-    size_t size;
-    void (*free_data)(void *data);
-};
+#include "../src/linked_list.h"
 
 // Fonction de libération pour des entiers
 static void free_int(void *data)
@@ -57,6 +51,50 @@ int compare_ints(const void *a, const void *b)
     return (*(int *)a - *(int *)b);
 }
 
+static size_t comparisons;
+
+static int counting_compare_ints(const void *a, const void *b)
+{
+    comparisons++;
+    return compare_ints(a, b);
+}
+
+static int is_sorted_list(LinkedList *list)
+{
+    for (Node *current = list->head; current && current->next;
+         current = current->next)
+    {
+        if (compare_ints(current->data, current->next->data) > 0)
+            return 0;
+    }
+    return 1;
+}
+
+static LinkedList *make_int_list(const int *values, size_t count)
+{
+    LinkedList *list = init_linked_list(free_int);
+    for (size_t i = 0; i < count; i++)
+    {
+        int *num = malloc(sizeof(int));
+        *num = values[i];
+        append(list, num);
+    }
+    return list;
+}
+
+static int list_equals(LinkedList *list, const int *values, size_t count)
+{
+    if (list->size != count)
+        return 0;
+    Node *current = list->head;
+    for (size_t i = 0; i < count; i++, current = current->next)
+    {
+        if (!current || *(int *)current->data != values[i])
+            return 0;
+    }
+    return current == NULL;
+}
+
 // Fonctions de test
 
 int test_list_initialization()
@@ -231,3 +269,822 @@ int test_sort()
     print_test_result("test_sort", passed);
     return passed;
 }
+
+int test_top_k()
+{
+    int values[] = {42, 7, 19, 3, 25, 11, 3, 30};
+    LinkedList *list = make_int_list(values, 8);
+
+    LinkedList *smallest = top_k(list, 3, compare_ints);
+    int expected[] = {3, 3, 7};
+    LinkedList *all = top_k(list, 20, compare_ints);
+    int sorted[] = {3, 3, 7, 11, 19, 25, 30, 42};
+
+    int passed = list_equals(smallest, expected, 3)
+        && list_equals(all, sorted, 8) && list_equals(list, values, 8);
+
+    free_linked_list(smallest);
+    free_linked_list(all);
+    free_linked_list(list);
+    print_test_result("test_top_k", passed);
+    return passed;
+}
+
+int test_partial_sort()
+{
+    int values[] = {42, 7, 19, 3, 25, 11, 30};
+    LinkedList *list = make_int_list(values, 7);
+
+    partial_sort(list, 3, compare_ints);
+    int expected[] = {3, 7, 11, 42, 19, 25, 30};
+
+    int passed = list_equals(list, expected, 7);
+
+    free_linked_list(list);
+    print_test_result("test_partial_sort", passed);
+    return passed;
+}
+
+int test_sort_presorted()
+{
+    int values[100];
+    for (int i = 0; i < 100; i++)
+        values[i] = i;
+    LinkedList *list = make_int_list(values, 100);
+
+    comparisons = 0;
+    sort(list, counting_compare_ints);
+    int passed = list_equals(list, values, 100) && comparisons == 99;
+
+    free_linked_list(list);
+    print_test_result("test_sort_presorted", passed);
+    return passed;
+}
+
+int test_sort_reversed()
+{
+    int values[100];
+    int expected[100];
+    for (int i = 0; i < 100; i++)
+    {
+        values[i] = 99 - i;
+        expected[i] = i;
+    }
+    LinkedList *list = make_int_list(values, 100);
+
+    comparisons = 0;
+    sort(list, counting_compare_ints);
+    int passed = list_equals(list, expected, 100) && comparisons == 99;
+
+    free_linked_list(list);
+    print_test_result("test_sort_reversed", passed);
+    return passed;
+}
+
+int test_sort_runs()
+{
+    int values[5000];
+    unsigned int seed = 12345;
+    for (int i = 0; i < 5000; i++)
+    {
+        // Sorted runs of varying length with late arrivals mixed in
+        seed = seed * 1103515245 + 12345;
+        values[i] = (seed >> 16) % 7 == 0 ? (int)((seed >> 8) % 5000) : i;
+    }
+    LinkedList *list = make_int_list(values, 5000);
+
+    sort(list, compare_ints);
+    int passed = list->size == 5000 && is_sorted_list(list);
+
+    free_linked_list(list);
+    print_test_result("test_sort_runs", passed);
+    return passed;
+}
+
+int test_insert_sorted()
+{
+    int values[] = {10, 20, 30};
+    LinkedList *list = make_int_list(values, 3);
+    void *first_twenty = get_at(list, 1);
+
+    int inserted[] = {25, 5, 35, 20};
+    for (int i = 0; i < 4; i++)
+    {
+        int *num = malloc(sizeof(int));
+        *num = inserted[i];
+        insert_sorted(list, num, compare_ints);
+    }
+
+    int expected[] = {5, 10, 20, 20, 25, 30, 35};
+    int passed =
+        list_equals(list, expected, 7) && get_at(list, 2) == first_twenty;
+
+    free_linked_list(list);
+    print_test_result("test_insert_sorted", passed);
+    return passed;
+}
+
+int test_merge_sorted()
+{
+    int left_values[] = {1, 4, 9};
+    int right_values[] = {2, 3, 10, 11};
+    LinkedList *left = make_int_list(left_values, 3);
+    LinkedList *right = make_int_list(right_values, 4);
+
+    merge_sorted(left, right, compare_ints);
+
+    int expected[] = {1, 2, 3, 4, 9, 10, 11};
+    int passed = list_equals(left, expected, 7) && right->size == 0
+        && right->head == NULL;
+
+    free_linked_list(left);
+    free_linked_list(right);
+    print_test_result("test_merge_sorted", passed);
+    return passed;
+}
+
+int test_kway_merge()
+{
+    int first[] = {1, 5, 9};
+    int second[] = {2, 6};
+    int third[] = {0, 3, 4, 12};
+    LinkedList *lists[4] = {make_int_list(first, 3), make_int_list(NULL, 0),
+                            make_int_list(second, 2), make_int_list(third, 4)};
+
+    LinkedList *merged = kway_merge(lists, 4, compare_ints);
+
+    int expected[] = {0, 1, 2, 3, 4, 5, 6, 9, 12};
+    int passed = list_equals(merged, expected, 9);
+    for (int i = 0; i < 4; i++)
+    {
+        passed = passed && lists[i]->size == 0;
+        free_linked_list(lists[i]);
+    }
+
+    free_linked_list(merged);
+    print_test_result("test_kway_merge", passed);
+    return passed;
+}
+
+int test_find_sorted()
+{
+    int values[1000];
+    for (int i = 0; i < 1000; i++)
+        values[i] = 2 * i;
+    LinkedList *list = make_int_list(values, 1000);
+
+    int key = 842;
+    int *found = find_sorted(list, &key, compare_ints);
+    int passed = found && *found == 842;
+
+    key = 843;
+    passed = passed && find_sorted(list, &key, compare_ints) == NULL;
+
+    int *num = malloc(sizeof(int));
+    *num = 843;
+    insert_sorted(list, num, compare_ints);
+    passed = passed && find_sorted(list, &key, compare_ints) == num;
+
+    key = -1;
+    passed = passed && find_sorted(list, &key, compare_ints) == NULL;
+    key = 1998;
+    found = find_sorted(list, &key, compare_ints);
+    passed = passed && found && *found == 1998;
+
+    free_linked_list(list);
+    print_test_result("test_find_sorted", passed);
+    return passed;
+}
+
+int test_list_array_conversion()
+{
+    void *items[5];
+    for (int i = 0; i < 5; i++)
+    {
+        int *num = malloc(sizeof(int));
+        *num = (i + 1) * 10;
+        items[i] = num;
+    }
+    LinkedList *list = list_from_array(items, 5, free_int);
+
+    int expected[] = {10, 20, 30, 40, 50};
+    int passed = list_length(list) == 5 && list_equals(list, expected, 5);
+
+    // Nodes from the block are released one by one like any other node
+    remove_at(list, 0);
+    remove_at(list, 2);
+    int *num = malloc(sizeof(int));
+    *num = 60;
+    append(list, num);
+
+    void *out[4];
+    size_t count = list_to_array(list, out);
+    passed = passed && count == 4 && *(int *)out[0] == 20
+        && *(int *)out[1] == 30 && *(int *)out[2] == 50
+        && *(int *)out[3] == 60;
+
+    free_linked_list(list);
+    print_test_result("test_list_array_conversion", passed);
+    return passed;
+}
+
+static void *sum_ints(void *acc, void *data)
+{
+    *(int *)acc += *(int *)data;
+    return acc;
+}
+
+static void *min_int(void *acc, void *data)
+{
+    if (*(int *)data < *(int *)acc)
+        *(int *)acc = *(int *)data;
+    return acc;
+}
+
+static void *zero_int(void)
+{
+    int *acc = malloc(sizeof(int));
+    *acc = 0;
+    return acc;
+}
+
+static void *max_int_value(void)
+{
+    int *acc = malloc(sizeof(int));
+    *acc = 1 << 30;
+    return acc;
+}
+
+typedef struct Histogram
+{
+    size_t counts[2];
+} Histogram;
+
+static void *empty_histogram(void)
+{
+    return calloc(1, sizeof(Histogram));
+}
+
+static void *count_parity(void *acc, void *data)
+{
+    ((Histogram *)acc)->counts[*(int *)data % 2]++;
+    return acc;
+}
+
+static void *merge_histograms(void *acc, void *other)
+{
+    for (int i = 0; i < 2; i++)
+        ((Histogram *)acc)->counts[i] += ((Histogram *)other)->counts[i];
+    return acc;
+}
+
+static void free_histogram(void *acc)
+{
+    free(acc);
+}
+
+int test_reduce()
+{
+    int values[] = {4, 8, 15, 16, 23, 42};
+    LinkedList *list = make_int_list(values, 6);
+
+    int sum = 0;
+    int *result = reduce(list, &sum, sum_ints);
+    int passed = result == &sum && sum == 108;
+
+    LinkedList *empty = init_linked_list(free_int);
+    passed = passed && reduce(empty, &sum, sum_ints) == &sum;
+
+    free_linked_list(list);
+    free_linked_list(empty);
+    print_test_result("test_reduce", passed);
+    return passed;
+}
+
+int test_parallel_reduce()
+{
+    int values[10000];
+    for (int i = 0; i < 10000; i++)
+        values[i] = (i * 7919) % 10007 + 5;
+    LinkedList *list = make_int_list(values, 10000);
+
+    int passed = 1;
+    size_t thread_counts[] = {0, 1, 3, 8};
+    for (int t = 0; t < 4; t++)
+    {
+        int *sum = parallel_reduce(list, zero_int, sum_ints, NULL, free_int,
+                                   thread_counts[t]);
+        int *min = parallel_reduce(list, max_int_value, min_int, NULL,
+                                   free_int, thread_counts[t]);
+        int expected = 0;
+        for (int i = 0; i < 10000; i++)
+            expected += values[i];
+        passed = passed && *sum == expected && *min == 5;
+        free(sum);
+        free(min);
+    }
+
+    // Accumulators of another type than the elements, over a list that does
+    // not own its elements
+    LinkedList *borrowed = init_linked_list(NULL);
+    for (int i = 0; i < 10000; i++)
+        append(borrowed, &values[i]);
+    Histogram *histogram = parallel_reduce(borrowed, empty_histogram,
+                                           count_parity, merge_histograms,
+                                           free_histogram, 3);
+    passed = passed && histogram->counts[0] + histogram->counts[1] == 10000;
+    for (int i = 0; i < 10000; i++)
+        histogram->counts[values[i] % 2]--;
+    passed = passed && histogram->counts[0] == 0 && histogram->counts[1] == 0;
+    free_histogram(histogram);
+    free_linked_list(borrowed);
+
+    LinkedList *empty = init_linked_list(free_int);
+    int *zero = parallel_reduce(empty, zero_int, sum_ints, NULL, free_int, 4);
+    passed = passed && *zero == 0;
+    free(zero);
+
+    free_linked_list(empty);
+    free_linked_list(list);
+    print_test_result("test_parallel_reduce", passed);
+    return passed;
+}
+
+static int prefetch_sum;
+
+static void add_to_prefetch_sum(void *data)
+{
+    prefetch_sum += *(int *)data;
+}
+
+int test_foreach_prefetch()
+{
+    int values[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    LinkedList *list = make_int_list(values, 10);
+
+    int passed = 1;
+    size_t distances[] = {0, 1, 9, 10, 100};
+    for (int i = 0; i < 5; i++)
+    {
+        set_prefetch_distance(distances[i]);
+        set_prefetch_payloads(i % 2);
+        prefetch_sum = 0;
+        foreach(list, add_to_prefetch_sum);
+        passed = passed && prefetch_sum == 55;
+    }
+    set_prefetch_distance(0);
+    set_prefetch_payloads(1);
+
+    free_linked_list(list);
+    print_test_result("test_foreach_prefetch", passed);
+    return passed;
+}
+
+static int is_contiguous(LinkedList *list)
+{
+    Node *current = list->head;
+    for (; current && current->next; current = current->next)
+    {
+        if (current->next != current + 1)
+            return 0;
+    }
+    return 1;
+}
+
+int test_list_compact()
+{
+    int values[] = {5, 1, 4, 2, 3, 9, 7, 8, 6, 0};
+    LinkedList *list = make_int_list(values, 10);
+    sort(list, compare_ints);
+
+    int expected[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int passed = list_fragmentation(list) > 0;
+    passed = passed && list_compact(list) == 0;
+    passed = passed && list_equals(list, expected, 10) && is_contiguous(list)
+        && list_fragmentation(list) == 0;
+
+    // Nodes of the new block are released one by one as they are removed
+    remove_at(list, 0);
+    remove_at(list, 4);
+    int remaining[] = {1, 2, 3, 4, 6, 7, 8, 9};
+    passed = passed && list_equals(list, remaining, 8)
+        && list_compact(list) == 0 && list_equals(list, remaining, 8)
+        && is_contiguous(list);
+
+    // A list whose clones are gone is still compacted
+    LinkedList *scattered = make_int_list(values, 10);
+    sort(scattered, compare_ints);
+    free_linked_list(list_clone_cow(scattered));
+    passed = passed && list_compact(scattered) == 0
+        && list_equals(scattered, expected, 10) && is_contiguous(scattered);
+    free_linked_list(scattered);
+
+    LinkedList *empty = init_linked_list(free_int);
+    passed = passed && list_compact(empty) == 0 && empty->head == NULL;
+
+    free_linked_list(empty);
+    free_linked_list(list);
+    print_test_result("test_list_compact", passed);
+    return passed;
+}
+
+int test_auto_compact()
+{
+    LinkedList *list = init_linked_list(free_int);
+    list_set_auto_compact(list, 0.5);
+
+    // Insert every value at the front, so that the list order is the reverse
+    // of the allocation order until it gets compacted
+    int passed = 1;
+    for (int i = 0; i < 100; i++)
+    {
+        int *num = malloc(sizeof(int));
+        *num = 99 - i;
+        insert_at(list, num, 0);
+        if (list->churn == 0)
+            passed = passed && is_contiguous(list);
+    }
+
+    int sorted = 1;
+    Node *current = list->head;
+    for (int i = 0; i < 100; i++, current = current->next)
+        sorted = sorted && current && *(int *)current->data == i;
+    passed = passed && sorted && list->size == 100 && list->churn < 50;
+
+    list_set_auto_compact(list, 0);
+    for (int i = 0; i < 50; i++)
+        remove_at(list, 50);
+    passed = passed && list->size == 50 && list->churn == 50;
+
+    free_linked_list(list);
+    print_test_result("test_auto_compact", passed);
+    return passed;
+}
+
+int test_list_clone_cow()
+{
+    int values[] = {4, 2, 5, 1, 3};
+    LinkedList *list = make_int_list(values, 5);
+    LinkedList *clone = list_clone_cow(list);
+
+    int passed = clone && clone->head == list->head
+        && list_equals(clone, values, 5);
+
+    // Mutating the clone gives it its own nodes and leaves the list alone
+    static int extra = 6;
+    append(clone, &extra);
+    int appended[] = {4, 2, 5, 1, 3, 6};
+    passed = passed && clone->head != list->head
+        && list_equals(clone, appended, 6) && list_equals(list, values, 5);
+
+    // And the other way around
+    LinkedList *second = list_clone_cow(list);
+    sort(list, compare_ints);
+    int sorted[] = {1, 2, 3, 4, 5};
+    passed = passed && list_equals(list, sorted, 5)
+        && list_equals(second, values, 5);
+    remove_at(second, 0);
+    passed = passed && list_equals(second, values + 1, 4)
+        && list_equals(list, sorted, 5);
+
+    free_linked_list(second);
+    free_linked_list(clone);
+    free_linked_list(list);
+    print_test_result("test_list_clone_cow", passed);
+    return passed;
+}
+
+int test_clone_cow_release()
+{
+    int values[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    LinkedList *list = make_int_list(values, 8);
+    LinkedList *clone = list_clone_cow(list);
+    LinkedList *nested = list_clone_cow(clone);
+
+    int passed = nested && nested->head == list->head
+        && list_equals(nested, values, 8);
+
+    // The shared nodes outlive the list that created them
+    sort(list, compare_ints);
+    list_compact(clone);
+    passed = passed && list_equals(clone, values, 8)
+        && clone->head != nested->head && list_equals(nested, values, 8);
+    free_linked_list(clone);
+    passed = passed && list_equals(nested, values, 8);
+
+    // The last user of a chain keeps it instead of copying it
+    Node *head = nested->head;
+    LinkedList *last = list_clone_cow(nested);
+    free_linked_list(last);
+    remove_at(nested, 7);
+    passed = passed && nested->head == head && list_equals(nested, values, 7);
+
+    free_linked_list(nested);
+    free_linked_list(list);
+    print_test_result("test_clone_cow_release", passed);
+    return passed;
+}
+
+// Sum the elements of a snapshot, then free it
+static void *sum_snapshot(void *arg)
+{
+    LinkedList *snapshot = arg;
+    long *sum = malloc(sizeof(long));
+    *sum = 0;
+    for (size_t i = 0; i < list_length(snapshot); i++)
+        *sum += *(int *)get_at(snapshot, i);
+    free_linked_list(snapshot);
+    return sum;
+}
+
+static size_t counted_frees;
+
+static void count_free_int(void *data)
+{
+    free(data);
+    counted_frees++;
+}
+
+static int is_below_two(void *data)
+{
+    return *(int *)data < 2;
+}
+
+static LinkedList *make_counted_list(int count)
+{
+    LinkedList *list = init_linked_list(count_free_int);
+    for (int i = 0; i < count; i++)
+    {
+        int *num = malloc(sizeof(int));
+        *num = i;
+        append(list, num);
+    }
+    return list;
+}
+
+int test_clone_cow_ownership()
+{
+    int values[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    LinkedList *list = make_int_list(values, 8);
+    LinkedList *clone = list_clone_cow(list);
+
+    // Elements removed from the list stay readable through the clone
+    remove_at(list, 0);
+    remove_at(list, 3);
+    int passed = *(int *)get_at(clone, 0) == 1
+        && list_equals(clone, values, 8);
+
+    // And so do the elements of a list freed before its clone
+    LinkedList *nested = list_clone_cow(clone);
+    free_linked_list(list);
+    free_linked_list(clone);
+    passed = passed && list_equals(nested, values, 8);
+    free_linked_list(nested);
+
+    // Lists unrelated to a live clone free their elements right away
+    counted_frees = 0;
+    LinkedList *config = make_counted_list(1);
+    LinkedList *snapshot = list_clone_cow(config);
+    LinkedList *unrelated = make_counted_list(1000);
+    for (int i = 0; i < 500; i++)
+        remove_at(unrelated, 0);
+    passed = passed && counted_frees == 500;
+    free_linked_list(unrelated);
+    passed = passed && counted_frees == 1000;
+
+    // Elements moved out of a cloned list wait for its clones too, and
+    // are freed with the last of them
+    LinkedList *moved = make_counted_list(4);
+    merge_sorted(moved, config, compare_ints);
+    LinkedList *rejected = partition(moved, is_below_two);
+    free_linked_list(rejected);
+    free_linked_list(moved);
+    free_linked_list(config);
+    passed = passed && counted_frees == 1000
+        && *(int *)get_at(snapshot, 0) == 0;
+    free_linked_list(snapshot);
+    passed = passed && counted_frees == 1005;
+
+    // Snapshots handed to workers while the list keeps changing
+    list = make_int_list(values, 8);
+    pthread_t workers[16];
+    for (int i = 0; i < 16; i++)
+    {
+        pthread_create(&workers[i], NULL, sum_snapshot, list_clone_cow(list));
+        int *num = malloc(sizeof(int));
+        *num = 1;
+        remove_at(list, 0);
+        append(list, num);
+    }
+    for (int i = 0; i < 16; i++)
+    {
+        long *sum;
+        pthread_join(workers[i], (void **)&sum);
+        passed = passed && *sum > 0;
+        free(sum);
+    }
+    passed = passed && list_length(list) == 8;
+    free_linked_list(list);
+
+    print_test_result("test_clone_cow_ownership", passed);
+    return passed;
+}
+
+static size_t hash_int(const void *data)
+{
+    return (size_t)*(const int *)data;
+}
+
+static int equal_ints(const void *a, const void *b)
+{
+    return *(const int *)a == *(const int *)b;
+}
+
+int test_hash_index()
+{
+    LinkedList *list = init_linked_list(free_int);
+    for (int i = 0; i < 1000; i++)
+    {
+        int *num = malloc(sizeof(int));
+        *num = i * 3;
+        append(list, num);
+    }
+    int passed = list_attach_index(list, hash_int, equal_ints) == 0;
+
+    int found = 0;
+    for (int key = 0; key < 3000; key++)
+        found += list_contains(list, &key);
+    int key = 2997;
+    passed = passed && found == 1000 && *(int *)list_find(list, &key) == 2997;
+
+    // Removing keys, in the middle and at the tail, and keeping the others
+    for (int i = 0; i < 1000; i += 2)
+    {
+        key = i * 3;
+        passed = passed && list_remove_key(list, &key) == 1;
+    }
+    key = 2997;
+    passed = passed && list_remove_key(list, &key) == 1
+        && list_remove_key(list, &key) == 0 && list->size == 499;
+
+    int expected = 3;
+    for (Node *current = list->head; current; current = current->next)
+    {
+        passed = passed && *(int *)current->data == expected;
+        expected += 6;
+    }
+    found = 0;
+    for (key = 0; key < 3000; key++)
+        found += list_contains(list, &key);
+    passed = passed && found == 499;
+
+    free_linked_list(list);
+    print_test_result("test_hash_index", passed);
+    return passed;
+}
+
+int test_hash_index_sync()
+{
+    int values[] = {8, 3, 5, 1};
+    LinkedList *list = make_int_list(values, 4);
+    list_attach_index(list, hash_int, equal_ints);
+
+    int *num = malloc(sizeof(int));
+    *num = 7;
+    insert_at(list, num, 2);
+    remove_at(list, 0);
+    int key = 7;
+    int missing = 8;
+    int passed = list_contains(list, &key) && !list_contains(list, &missing);
+
+    // Relinking and relocating nodes keep the index valid
+    sort(list, compare_ints);
+    list_compact(list);
+    LinkedList *clone = list_clone_cow(list);
+    num = malloc(sizeof(int));
+    *num = 9;
+    append(list, num);
+    int present[] = {1, 3, 5, 7, 9};
+    for (int i = 0; i < 5; i++)
+        passed = passed && list_contains(list, &present[i]);
+
+    int others[] = {2, 4};
+    LinkedList *other = make_int_list(others, 2);
+    list_attach_index(other, hash_int, equal_ints);
+    merge_sorted(list, other, compare_ints);
+    key = 4;
+    passed = passed && list_contains(list, &key) && !list_contains(other, &key)
+        && list_remove_key(list, &key) == 1 && !list_contains(list, &key);
+
+    // Without an index, elements are looked up by address
+    passed = passed && list_find(clone, &key) == NULL
+        && list_find(clone, clone->head->data) == clone->head->data;
+
+    free_linked_list(other);
+    free_linked_list(clone);
+    free_linked_list(list);
+    print_test_result("test_hash_index_sync", passed);
+    return passed;
+}
+
+static int is_even(void *data)
+{
+    return *(int *)data % 2 == 0;
+}
+
+// Bucket of an element: its value, which group_by takes modulo nbuckets
+static size_t int_bucket(void *data)
+{
+    return (size_t)*(int *)data;
+}
+
+int test_partition()
+{
+    int values[] = {4, 7, 2, 9, 8, 1, 6};
+    LinkedList *list = make_int_list(values, 7);
+    Node *first = list->head;
+
+    LinkedList *odd = partition(list, is_even);
+    int even_values[] = {4, 2, 8, 6};
+    int odd_values[] = {7, 9, 1};
+    int passed = odd && list_equals(list, even_values, 4)
+        && list_equals(odd, odd_values, 3) && list->head == first;
+
+    LinkedList *none = partition(odd, is_even);
+    passed = passed && list_equals(odd, NULL, 0)
+        && list_equals(none, odd_values, 3);
+
+    free_linked_list(none);
+    free_linked_list(odd);
+    free_linked_list(list);
+    print_test_result("test_partition", passed);
+    return passed;
+}
+
+// Check that bucket b holds the values congruent to b modulo 3, in order
+static int buckets_match(LinkedList **buckets, const int *values, size_t count)
+{
+    for (size_t b = 0; b < 3; b++)
+    {
+        Node *current = buckets[b]->head;
+        size_t size = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            if ((size_t)values[i] % 3 != b)
+                continue;
+            if (!current || *(int *)current->data != values[i])
+                return 0;
+            current = current->next;
+            size++;
+        }
+        if (current || buckets[b]->size != size)
+            return 0;
+    }
+    return 1;
+}
+
+static void free_buckets(LinkedList **buckets, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        free_linked_list(buckets[i]);
+    free(buckets);
+}
+
+int test_group_by()
+{
+    int values[] = {5, 3, 9, 4, 1, 0, 8, 7, 6, 2};
+    LinkedList *list = make_int_list(values, 10);
+
+    LinkedList **buckets = group_by(list, int_bucket, 3);
+    int passed = buckets && buckets_match(buckets, values, 10)
+        && list->size == 0 && list->head == NULL;
+    passed = passed && group_by(list, int_bucket, 0) == NULL;
+
+    free_buckets(buckets, 3);
+    free_linked_list(list);
+    print_test_result("test_group_by", passed);
+    return passed;
+}
+
+int test_group_by_parallel()
+{
+    int values[10000];
+    for (int i = 0; i < 10000; i++)
+        values[i] = (i * 7919) % 10007;
+
+    int passed = 1;
+    size_t thread_counts[] = {0, 1, 3, 8};
+    for (int t = 0; t < 4; t++)
+    {
+        LinkedList *list = make_int_list(values, 10000);
+        LinkedList **buckets =
+            group_by_parallel(list, int_bucket, 3, thread_counts[t]);
+        passed = passed && buckets && buckets_match(buckets, values, 10000)
+            && list->size == 0;
+        free_buckets(buckets, 3);
+        free_linked_list(list);
+    }
+
+    print_test_result("test_group_by_parallel", passed);
+    return passed;
+}
@@ -10,5 +10,28 @@ int test_foreach();
 int test_map();
 int test_filter();
 int test_sort();
+int test_top_k();
+int test_partial_sort();
+int test_sort_presorted();
+int test_sort_reversed();
+int test_sort_runs();
+int test_insert_sorted();
+int test_merge_sorted();
+int test_kway_merge();
+int test_find_sorted();
+int test_list_array_conversion();
+int test_reduce();
+int test_parallel_reduce();
+int test_foreach_prefetch();
+int test_list_compact();
+int test_auto_compact();
+int test_list_clone_cow();
+int test_clone_cow_release();
+int test_clone_cow_ownership();
+int test_hash_index();
+int test_hash_index_sync();
+int test_partition();
+int test_group_by();
+int test_group_by_parallel();
 
 #endif /* TEST_LINKED_LIST_H */
\ No newline at end of file
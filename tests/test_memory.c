@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/utils.h"
+#include "../src/node.h"
+
+static void free_int(void *data)
+{
+    free(data);
+}
+
+static void print_test_result(const char *test_name, int passed)
+{
+    if (passed)
+    {
+        printf("[SUCCESS] %s\n", test_name);
+    }
+    else
+    {
+        printf("[FAILURE] %s\n", test_name);
+    }
+}
+
+static size_t int_size(const void *data)
+{
+    (void)data;
+    return sizeof(int);
+}
+
+static LinkedList *make_list(size_t count)
+{
+    LinkedList *list = init_linked_list(free_int);
+    for (size_t i = 0; i < count; i++)
+    {
+        int *num = malloc(sizeof(int));
+        *num = (int)i;
+        insert_at(list, num, 0);
+    }
+    return list;
+}
+
+int test_list_memory_usage()
+{
+    LinkedList *list = make_list(100);
+
+    MemoryUsage scattered = list_memory_usage(list, int_size);
+    int passed = scattered.elements == 100
+        && scattered.node_bytes == 100 * sizeof(Node)
+        && scattered.payload_bytes == 100 * sizeof(int)
+        && scattered.overhead_bytes > 0 && scattered.overhead_ratio > 0
+        && scattered.overhead_ratio < 1;
+
+    // One block saves the per-node allocator headers
+    list_compact(list);
+    MemoryUsage compacted = list_memory_usage(list, int_size);
+    passed = passed && compacted.elements == 100
+        && compacted.node_bytes == scattered.node_bytes
+        && compacted.overhead_bytes < scattered.overhead_bytes;
+
+    MemoryUsage nodes_only = list_memory_usage(list, NULL);
+    passed = passed && nodes_only.payload_bytes == 0
+        && nodes_only.overhead_ratio == 1;
+
+    LinkedList *empty = init_linked_list(free_int);
+    MemoryUsage header = list_memory_usage(empty, int_size);
+    passed = passed && header.elements == 0 && header.node_bytes == 0
+        && header.overhead_bytes > 0;
+
+    free_linked_list(empty);
+    free_linked_list(list);
+    print_test_result("test_list_memory_usage", passed);
+    return passed;
+}
+
+int test_stack_memory_usage()
+{
+    int values[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    void *items[8];
+    for (int i = 0; i < 8; i++)
+        items[i] = &values[i];
+    Stack *stack = stack_from_array(items, 8, NULL);
+
+    MemoryUsage before = stack_memory_usage(stack, int_size);
+    int passed = before.elements == 8 && before.node_bytes == 8 * sizeof(Node)
+        && before.payload_bytes == 8 * sizeof(int);
+
+    // Popped nodes stay in the block, and are charged to the remaining ones
+    pop(stack);
+    pop(stack);
+    MemoryUsage after = stack_memory_usage(stack, int_size);
+    passed = passed && after.elements == 6
+        && after.payload_bytes == 6 * sizeof(int)
+        && after.overhead_bytes > before.overhead_bytes;
+
+    free_stack(stack);
+    print_test_result("test_stack_memory_usage", passed);
+    return passed;
+}
+
+static void count_entries(const char *name, const MemoryUsage *usage,
+                          void *context)
+{
+    size_t *elements = context;
+    if (strcmp(name, "tenant-a") == 0)
+        elements[0] += usage->elements;
+    else if (strcmp(name, "tenant-b") == 0)
+        elements[1] += usage->elements;
+}
+
+int test_memory_registry()
+{
+    MemoryUsage baseline = memory_registry_total();
+
+    LinkedList *list = make_list(10);
+    Stack *stack = init_stack(NULL);
+    int passed = list_track_memory(list, "tenant-a", int_size) == 0
+        && stack_track_memory(stack, "tenant-b", NULL) == 0;
+
+    // The registry keeps the latest measurement of each container
+    int value = 42;
+    push(stack, &value);
+    push(stack, &value);
+    MemoryUsage total = memory_registry_total();
+    passed = passed && total.elements == baseline.elements + 10
+        && total.payload_bytes == baseline.payload_bytes + 10 * sizeof(int);
+    stack_memory_usage(stack, NULL);
+    total = memory_registry_total();
+    passed = passed && total.elements == baseline.elements + 12
+        && total.overhead_ratio > 0 && total.overhead_ratio < 1;
+
+    size_t elements[2] = {0, 0};
+    memory_registry_export(count_entries, elements);
+    passed = passed && elements[0] == 10 && elements[1] == 2;
+
+    free_linked_list(list);
+    elements[0] = elements[1] = 0;
+    memory_registry_export(count_entries, elements);
+    passed = passed && elements[0] == 0 && elements[1] == 2
+        && memory_registry_total().elements == baseline.elements + 2;
+
+    free_stack(stack);
+    passed = passed && memory_registry_total().elements == baseline.elements;
+    print_test_result("test_memory_registry", passed);
+    return passed;
+}
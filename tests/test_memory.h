@@ -0,0 +1,8 @@
+#ifndef TEST_MEMORY_H
+#define TEST_MEMORY_H
+
+int test_list_memory_usage();
+int test_stack_memory_usage();
+int test_memory_registry();
+
+#endif /* TEST_MEMORY_H */
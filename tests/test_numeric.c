@@ -0,0 +1,141 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/utils.h"
+
+#define COUNT 1003
+
+static void free_int(void *data)
+{
+    free(data);
+}
+
+static void print_test_result(const char *test_name, int passed)
+{
+    if (passed)
+    {
+        printf("[SUCCESS] %s\n", test_name);
+    }
+    else
+    {
+        printf("[FAILURE] %s\n", test_name);
+    }
+}
+
+// Integer values so that every kernel gives exact results; the odd length
+// exercises the scalar tails of the vector loops
+static NumericArray *make_array(void)
+{
+    NumericArray *array = init_numeric_array(0);
+    for (int i = 0; i < COUNT; i++)
+        num_push(array, (double)((i * 37) % 101 - 50));
+    return array;
+}
+
+static const NumericIsa isas[] = {NUMERIC_SCALAR, NUMERIC_SSE2, NUMERIC_AVX2};
+
+int test_numeric_from_list()
+{
+    LinkedList *list = init_linked_list(free_int);
+    for (int i = 0; i < 20; i++)
+    {
+        int *num = malloc(sizeof(int));
+        *num = i * 2;
+        append(list, num);
+    }
+
+    NumericArray *array = numeric_from_list(list, NUMERIC_INT);
+    int passed = num_length(array) == 20 && num_data(array)[7] == 14.0
+        && num_sum(array) == 380.0;
+
+    free_numeric_array(array);
+    free_linked_list(list);
+    print_test_result("test_numeric_from_list", passed);
+    return passed;
+}
+
+int test_numeric_aggregates()
+{
+    NumericArray *array = make_array();
+    NumericArray *empty = init_numeric_array(0);
+    NumericIsa detected = numeric_isa();
+
+    double sum = 0;
+    for (int i = 0; i < COUNT; i++)
+        sum += num_data(array)[i];
+
+    int passed = 1;
+    for (int i = 0; i < 3; i++)
+    {
+        numeric_set_isa(isas[i]);
+        passed = passed && num_sum(array) == sum && num_min(array) == -50.0
+            && num_max(array) == 50.0 && num_sum(empty) == 0.0
+            && num_min(empty) == INFINITY;
+    }
+    numeric_set_isa(detected);
+
+    free_numeric_array(array);
+    free_numeric_array(empty);
+    print_test_result("test_numeric_aggregates", passed);
+    return passed;
+}
+
+int test_numeric_count_and_filter()
+{
+    NumericArray *array = make_array();
+    NumericIsa detected = numeric_isa();
+    NumericOp ops[] = {NUMERIC_LT, NUMERIC_LE, NUMERIC_GT,
+                       NUMERIC_GE, NUMERIC_EQ, NUMERIC_NE};
+
+    int passed = 1;
+    for (int o = 0; o < 6; o++)
+    {
+        numeric_set_isa(NUMERIC_SCALAR);
+        size_t expected = num_count_if(array, ops[o], 10.0);
+        NumericArray *reference = num_filter(array, ops[o], 10.0);
+
+        for (int i = 1; i < 3; i++)
+        {
+            numeric_set_isa(isas[i]);
+            NumericArray *filtered = num_filter(array, ops[o], 10.0);
+            passed = passed && num_count_if(array, ops[o], 10.0) == expected
+                && num_length(filtered) == expected;
+            for (size_t j = 0; passed && j < expected; j++)
+                passed = num_data(filtered)[j] == num_data(reference)[j];
+            free_numeric_array(filtered);
+        }
+        passed = passed && num_length(reference) == expected;
+        free_numeric_array(reference);
+    }
+    numeric_set_isa(detected);
+
+    int greater = 0;
+    for (int i = 0; i < COUNT; i++)
+        greater += (i * 37) % 101 - 50 > 10;
+    passed = passed && num_count_if(array, NUMERIC_GT, 10.0) == (size_t)greater;
+
+    free_numeric_array(array);
+    print_test_result("test_numeric_count_and_filter", passed);
+    return passed;
+}
+
+int test_numeric_map_affine()
+{
+    NumericIsa detected = numeric_isa();
+    int passed = 1;
+
+    for (int i = 0; i < 3; i++)
+    {
+        numeric_set_isa(isas[i]);
+        NumericArray *array = make_array();
+        num_map_affine(array, 2.0, 1.0);
+        for (int j = 0; passed && j < COUNT; j++)
+            passed = num_data(array)[j] == 2.0 * ((j * 37) % 101 - 50) + 1.0;
+        free_numeric_array(array);
+    }
+    numeric_set_isa(detected);
+
+    print_test_result("test_numeric_map_affine", passed);
+    return passed;
+}
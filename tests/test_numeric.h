@@ -0,0 +1,9 @@
+#ifndef TEST_NUMERIC_H
+#define TEST_NUMERIC_H
+
+int test_numeric_from_list();
+int test_numeric_aggregates();
+int test_numeric_count_and_filter();
+int test_numeric_map_affine();
+
+#endif /* TEST_NUMERIC_H */
@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/utils.h"
+
+static int freed_count = 0;
+
+static void free_int(void *data)
+{
+    free(data);
+    freed_count++;
+}
+
+static void print_test_result(const char *test_name, int passed)
+{
+    if (passed)
+    {
+        printf("[SUCCESS] %s\n", test_name);
+    }
+    else
+    {
+        printf("[FAILURE] %s\n", test_name);
+    }
+}
+
+static int compare_ints(const void *a, const void *b)
+{
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int *new_int(int value)
+{
+    int *num = malloc(sizeof(int));
+    *num = value;
+    return num;
+}
+
+// Pop every element and check that they come out in ascending order
+static int drains_sorted(PriorityQueue *pq, size_t expected)
+{
+    int previous = 0;
+    size_t count = 0;
+    int *num;
+    while ((num = pq_pop(pq)))
+    {
+        if (count > 0 && *num < previous)
+            return 0;
+        previous = *num;
+        count++;
+        free(num);
+    }
+    return count == expected && pq_length(pq) == 0;
+}
+
+int test_pqueue_push_pop()
+{
+    PriorityQueue *pq = init_pqueue(compare_ints, free_int);
+
+    int passed = pq_peek(pq) == NULL && pq_pop(pq) == NULL;
+    for (int i = 0; i < 1000; i++)
+        pq_push(pq, new_int((i * 7919) % 1009));
+    passed = passed && pq_length(pq) == 1000 && *(int *)pq_peek(pq) == 0;
+    passed = passed && drains_sorted(pq, 1000);
+
+    free_pqueue(pq);
+    print_test_result("test_pqueue_push_pop", passed);
+    return passed;
+}
+
+int test_pqueue_push_n()
+{
+    PriorityQueue *pq = init_pqueue(compare_ints, free_int);
+
+    void *items[500];
+    for (int i = 0; i < 500; i++)
+        items[i] = new_int(500 - i);
+    int passed = pq_push_n(pq, items, 500) == 0 && pq_length(pq) == 500
+        && *(int *)pq_peek(pq) == 1;
+
+    // A small batch onto a large queue is pushed one by one
+    for (int i = 0; i < 10; i++)
+        items[i] = new_int(-i);
+    passed = passed && pq_push_n(pq, items, 10) == 0
+        && *(int *)pq_peek(pq) == -9;
+    passed = passed && drains_sorted(pq, 510);
+
+    passed = passed && pq_push_n(pq, items, 0) == 0 && pq_length(pq) == 0;
+
+    free_pqueue(pq);
+    print_test_result("test_pqueue_push_n", passed);
+    return passed;
+}
+
+int test_pqueue_decrease_key()
+{
+    PriorityQueue *pq = init_pqueue(compare_ints, NULL);
+
+    int keys[100];
+    PQHandle handles[100];
+    int passed = 1;
+    for (int i = 0; i < 100; i++)
+    {
+        keys[i] = 1000 + i;
+        passed = passed && pq_push_handle(pq, &keys[i], &handles[i]) == 0;
+    }
+
+    // Give every third key a new, smaller priority in reverse order
+    for (int i = 99; i >= 0; i -= 3)
+    {
+        keys[i] = i - 100;
+        pq_decrease_key(pq, handles[i]);
+    }
+    passed = passed && pq_peek(pq) == &keys[0];
+
+    int previous = -1000;
+    for (int i = 0; i < 100; i++)
+    {
+        int *key = pq_pop(pq);
+        passed = passed && key && *key >= previous;
+        previous = key ? *key : previous;
+    }
+
+    // Handles of popped elements are reused
+    PQHandle reused;
+    passed = passed && pq_push_handle(pq, &keys[0], &reused) == 0
+        && reused < 100 && pq_pop(pq) == &keys[0];
+
+    free_pqueue(pq);
+    print_test_result("test_pqueue_decrease_key", passed);
+    return passed;
+}
+
+int test_free_pqueue()
+{
+    PriorityQueue *pq = init_pqueue(compare_ints, free_int);
+    for (int i = 0; i < 50; i++)
+        pq_push(pq, new_int(i));
+    free(pq_pop(pq));
+
+    freed_count = 0;
+    free_pqueue(pq);
+    int passed = freed_count == 49 && init_pqueue(NULL, NULL) == NULL;
+
+    print_test_result("test_free_pqueue", passed);
+    return passed;
+}
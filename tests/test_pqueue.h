@@ -0,0 +1,9 @@
+#ifndef TEST_PQUEUE_H
+#define TEST_PQUEUE_H
+
+int test_pqueue_push_pop();
+int test_pqueue_push_n();
+int test_pqueue_decrease_key();
+int test_free_pqueue();
+
+#endif /* TEST_PQUEUE_H */
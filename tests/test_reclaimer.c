@@ -0,0 +1,113 @@
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "../include/utils.h"
+
+static atomic_size_t freed = 0;
+
+static void count_free(void *data)
+{
+    free(data);
+    atomic_fetch_add(&freed, 1);
+}
+
+static void print_test_result(const char *test_name, int passed)
+{
+    if (passed)
+    {
+        printf("[SUCCESS] %s\n", test_name);
+    }
+    else
+    {
+        printf("[FAILURE] %s\n", test_name);
+    }
+}
+
+static LinkedList *make_list(size_t count)
+{
+    LinkedList *list = init_linked_list(count_free);
+    for (size_t i = 0; i < count; i++)
+    {
+        int *num = malloc(sizeof(int));
+        *num = (int)i;
+        insert_at(list, num, 0);
+    }
+    return list;
+}
+
+int test_free_linked_list_async()
+{
+    atomic_store(&freed, 0);
+    LinkedList *list = make_list(1000);
+    free_linked_list_async(list);
+    free_linked_list_async(init_linked_list(count_free));
+    free_linked_list_async(NULL);
+    utils_reclaimer_drain();
+
+    int passed = atomic_load(&freed) == 1000;
+    print_test_result("test_free_linked_list_async", passed);
+    return passed;
+}
+
+int test_free_stack_async()
+{
+    atomic_store(&freed, 0);
+    Stack *stack = init_stack(count_free);
+    for (int i = 0; i < 1000; i++)
+    {
+        int *num = malloc(sizeof(int));
+        *num = i;
+        push(stack, num);
+    }
+    free_stack_async(stack);
+    utils_reclaimer_drain();
+
+    int passed = atomic_load(&freed) == 1000;
+    print_test_result("test_free_stack_async", passed);
+    return passed;
+}
+
+int test_reclaimer_backpressure()
+{
+    // More lists than the queue holds, so that callers have to wait for the
+    // reclaimer, and a second round to restart it after the drain
+    int passed = 1;
+    for (int round = 0; round < 2; round++)
+    {
+        atomic_store(&freed, 0);
+        for (int i = 0; i < 200; i++)
+            free_linked_list_async(make_list(50));
+        utils_reclaimer_drain();
+        passed = passed && atomic_load(&freed) == 200 * 50;
+    }
+    utils_reclaimer_drain();
+
+    print_test_result("test_reclaimer_backpressure", passed);
+    return passed;
+}
+
+static void free_list_async(void *data)
+{
+    free_linked_list_async(data);
+}
+
+int test_reclaimer_nested_free()
+{
+    // Freeing the outer list on the reclaimer queues more lists than the
+    // queue holds from the reclaimer itself
+    atomic_store(&freed, 0);
+    LinkedList *outer = init_linked_list(free_list_async);
+    for (int i = 0; i < 100; i++)
+        append(outer, make_list(10));
+    free_linked_list_async(outer);
+
+    for (int i = 0; i < 500 && atomic_load(&freed) < 100 * 10; i++)
+        usleep(10000);
+    utils_reclaimer_drain();
+
+    int passed = atomic_load(&freed) == 100 * 10;
+    print_test_result("test_reclaimer_nested_free", passed);
+    return passed;
+}
@@ -0,0 +1,9 @@
+#ifndef TEST_RECLAIMER_H
+#define TEST_RECLAIMER_H
+
+int test_free_linked_list_async();
+int test_free_stack_async();
+int test_reclaimer_backpressure();
+int test_reclaimer_nested_free();
+
+#endif /* TEST_RECLAIMER_H */
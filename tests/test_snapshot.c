@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../include/utils.h"
+
+static void print_test_result(const char *test_name, int passed)
+{
+    if (passed)
+    {
+        printf("[SUCCESS] %s\n", test_name);
+    }
+    else
+    {
+        printf("[FAILURE] %s\n", test_name);
+    }
+}
+
+static void free_data(void *data)
+{
+    free(data);
+}
+
+static size_t serialize_string(const void *data, void *buffer,
+                               size_t capacity)
+{
+    size_t size = strlen(data) + 1;
+    if (size <= capacity)
+        memcpy(buffer, data, size);
+    return size;
+}
+
+// Create an empty temporary file and return its path in `path`
+static void temporary_path(char *path)
+{
+    strcpy(path, "/tmp/libutils_snapshot_XXXXXX");
+    int fd = mkstemp(path);
+    if (fd >= 0)
+        close(fd);
+}
+
+int test_snapshot_variable_records()
+{
+    // The third record is larger than the initial serialization buffer
+    char long_word[1000];
+    memset(long_word, 'x', sizeof(long_word) - 1);
+    long_word[sizeof(long_word) - 1] = '\0';
+    const char *words[] = {"", "apple", long_word, "pear"};
+    LinkedList *list = init_linked_list(free_data);
+    for (int i = 0; i < 4; i++)
+        append(list, strdup(words[i]));
+
+    char path[64];
+    temporary_path(path);
+    int passed = list_save(list, path, serialize_string) == 0;
+
+    ListSnapshot *snapshot = NULL;
+    LinkedList *loaded = list_load_mmap(path, &snapshot);
+    passed = passed && loaded && list_length(loaded) == 4
+        && snapshot_length(snapshot) == 4;
+    for (int i = 0; passed && i < 4; i++)
+    {
+        size_t size;
+        const char *record = snapshot_get(snapshot, i, &size);
+        passed = strcmp(get_at(loaded, i), words[i]) == 0
+            && record == get_at(loaded, i) && size == strlen(words[i]) + 1;
+    }
+    passed = passed && snapshot_get(snapshot, 4, NULL) == NULL;
+
+    free_linked_list(loaded);
+    free_snapshot(snapshot);
+    free_linked_list(list);
+    unlink(path);
+    print_test_result("test_snapshot_variable_records", passed);
+    return passed;
+}
+
+int test_snapshot_inline_records()
+{
+    LinkedList *list = init_linked_list(free_data);
+    for (int i = 0; i < 1000; i++)
+    {
+        int *num = malloc(sizeof(int));
+        *num = i * 3;
+        append(list, num);
+    }
+
+    char path[64];
+    temporary_path(path);
+    int passed = list_save_inline(list, path, sizeof(int)) == 0;
+
+    ListSnapshot *snapshot = NULL;
+    LinkedList *loaded = list_load_mmap(path, &snapshot);
+    passed = passed && loaded && list_length(loaded) == 1000;
+    for (int i = 0; passed && i < 1000; i++)
+        passed = *(int *)get_at(loaded, i) == i * 3;
+
+    // Payloads are writable, privately to the process
+    if (passed)
+        *(int *)get_at(loaded, 0) = 42;
+    passed = passed && *(const int *)snapshot_get(snapshot, 0, NULL) == 42;
+
+    free_linked_list(loaded);
+    free_snapshot(snapshot);
+    free_linked_list(list);
+    unlink(path);
+    print_test_result("test_snapshot_inline_records", passed);
+    return passed;
+}
+
+int test_snapshot_invalid_file()
+{
+    char path[64];
+    temporary_path(path);
+    FILE *file = fopen(path, "w");
+    fputs("not a snapshot, just some text long enough for a header", file);
+    fclose(file);
+
+    ListSnapshot *snapshot = NULL;
+    int passed = list_load_mmap(path, &snapshot) == NULL && snapshot == NULL
+        && list_load_mmap("/nonexistent/snapshot", &snapshot) == NULL;
+
+    unlink(path);
+    print_test_result("test_snapshot_invalid_file", passed);
+    return passed;
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_SNAPSHOT_H
+#define TEST_SNAPSHOT_H
+
+int test_snapshot_variable_records();
+int test_snapshot_inline_records();
+int test_snapshot_invalid_file();
+
+#endif /* TEST_SNAPSHOT_H */
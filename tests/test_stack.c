@@ -3,15 +3,7 @@
 #include <stdlib.h>
 
 #include "../include/utils.h"
-#include "../src/node.h"
-
-// Stack structure definition
-struct Stack
-{
-    struct Node *head;
-    size_t size;
-    void (*free_data)(void *data);
-};
+#include "../src/stack.h"
 
 // Function to free integer data in the stack
 static void free_int(void *data)
@@ -121,3 +113,28 @@ int test_stack_length()
     print_test_result("test_stack_length", passed);
     return passed;
 }
+
+int test_stack_array_conversion()
+{
+    void *items[3];
+    for (int i = 0; i < 3; i++)
+    {
+        int *num = malloc(sizeof(int));
+        *num = (i + 1) * 10;
+        items[i] = num;
+    }
+    Stack *stack = stack_from_array(items, 3, free_int);
+
+    void *out[3];
+    size_t count = stack_to_array(stack, out);
+    int passed = length(stack) == 3 && count == 3 && out[0] == items[0]
+        && out[1] == items[1] && out[2] == items[2];
+
+    int *popped_data = (int *)pop(stack);
+    passed = passed && *popped_data == 30 && length(stack) == 2;
+
+    free(popped_data);
+    free_stack(stack);
+    print_test_result("test_stack_array_conversion", passed);
+    return passed;
+}
@@ -7,5 +7,6 @@ int test_pop_elements();
 int test_pop_empty_stack();
 int test_is_empty();
 int test_stack_length();
+int test_stack_array_conversion();
 
 #endif /* TEST_STACK_H */
\ No newline at end of file